@@ -0,0 +1,367 @@
+// Microbenchmarks of the engine's hot paths, reporting time and heap
+// allocations per operation:
+//   chess_bench [filter SUBSTRING] [ms MIN_TIME] [format text|json]
+// Each benchmark runs for at least MIN_TIME milliseconds (default 300).
+// Compare runs of the same build type on the same machine.
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chess/allocations.hpp"
+#include "chess/batch_eval.hpp"
+#include "chess/board.hpp"
+#include "chess/cpu.hpp"
+#include "chess/evaluate.hpp"
+#include "chess/hash.hpp"
+#include "chess/internal/init.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/position.hpp"
+#include "chess/search.hpp"
+#include "chess/search_info.hpp"
+#include "chess/types.hpp"
+
+namespace {
+// Counted by the replacement operator new of chess_allocations; the
+// benchmarks run on this thread.
+std::uint64_t Allocations() {
+    return chess::allocations::count();
+}
+} // namespace
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr int kDefaultMinMs = 300;
+constexpr int kHashSizeMb = 16;
+constexpr int kTableBatch = 1024;
+constexpr int kSearchDepth = 4;
+
+constexpr std::array<std::string_view, 4> kOpening = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+    "r1bqk1nr/pppp1ppp/2n5/2b1p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5",
+};
+
+constexpr std::array<std::string_view, 4> kMiddlegame = {
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r1bq1rk1/pp2bppp/2n2n2/3p4/3P4/2NB1N2/PP3PPP/R1BQ1RK1 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+};
+
+constexpr std::array<std::string_view, 4> kEndgame = {
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    "8/8/8/4k3/8/8/4P3/4K3 w - - 0 1",
+    "8/5pk1/6p1/3B4/8/6P1/5PK1/8 b - - 0 40",
+};
+
+struct Options {
+    std::string_view filter;
+    int minMs = kDefaultMinMs;
+    bool json = false;
+};
+
+struct Result {
+    std::string name;
+    std::uint64_t ops;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+// Keeps benchmark results observable so the work is not optimized away.
+volatile std::uint64_t g_sink = 0;
+
+// Calls batch until minMs has passed; batch runs a fixed unit of work and
+// returns how many operations that was.
+template <typename Batch>
+void Run(std::string_view name, const Options& options, std::vector<Result>& results, Batch&& batch) {
+    if (!options.filter.empty() && name.find(options.filter) == std::string_view::npos) {
+        return;
+    }
+
+    batch();
+    const auto budget = std::chrono::milliseconds(options.minMs);
+    std::uint64_t ops = 0;
+    const std::uint64_t allocations = Allocations();
+    const auto start = Clock::now();
+    auto elapsed = Clock::duration::zero();
+    do {
+        ops += batch();
+        elapsed = Clock::now() - start;
+    } while (elapsed < budget);
+    const std::uint64_t allocated = Allocations() - allocations;
+
+    const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    results.push_back(Result{std::string(name), ops, ns / static_cast<double>(ops),
+                             static_cast<double>(allocated) / static_cast<double>(ops)});
+    if (!options.json) {
+        const Result& result = results.back();
+        std::cout << std::format("{:<24} {:>12.1f} ns/op {:>10.3f} allocs/op {:>12} ops\n", result.name,
+                                 result.nsPerOp, result.allocsPerOp, result.ops);
+    }
+}
+
+std::vector<std::unique_ptr<chess::Board>> LoadBoards(std::span<const std::string_view> fens) {
+    std::vector<std::unique_ptr<chess::Board>> boards;
+    for (const auto fen : fens) {
+        auto board = std::make_unique<chess::Board>();
+        board->parseFen(fen);
+        boards.push_back(std::move(board));
+    }
+    return boards;
+}
+
+std::uint64_t MoveGen(std::span<const std::unique_ptr<chess::Board>> boards) {
+    chess::MoveList list;
+    std::uint64_t checksum = 0;
+    for (const auto& board : boards) {
+        chess::movegen::generateAllMoves(*board, list);
+        checksum += static_cast<std::uint64_t>(list.size());
+    }
+    g_sink = g_sink + checksum;
+    return boards.size();
+}
+
+std::uint64_t MakeTake(std::span<const std::unique_ptr<chess::Board>> boards,
+                       std::span<const chess::MoveList> moves) {
+    std::uint64_t ops = 0;
+    std::uint64_t checksum = 0;
+    for (std::size_t index = 0; index < boards.size(); ++index) {
+        chess::Board& board = *boards[index];
+        const chess::MoveList& list = moves[index];
+        for (int move = 0; move < list.size(); ++move) {
+            board.makeMove(list[move]);
+            checksum ^= board.posKey();
+            board.takeMove();
+        }
+        ops += static_cast<std::uint64_t>(list.size());
+    }
+    g_sink = g_sink + checksum;
+    return ops;
+}
+
+void RunAll(const Options& options, std::vector<Result>& results) {
+    chess::HashTable table;
+    table.init(kHashSizeMb);
+
+    const auto opening = LoadBoards(kOpening);
+    const auto middlegame = LoadBoards(kMiddlegame);
+    const auto endgame = LoadBoards(kEndgame);
+
+    std::vector<std::string_view> all_fens;
+    all_fens.insert(all_fens.end(), kOpening.begin(), kOpening.end());
+    all_fens.insert(all_fens.end(), kMiddlegame.begin(), kMiddlegame.end());
+    all_fens.insert(all_fens.end(), kEndgame.begin(), kEndgame.end());
+    const auto all = LoadBoards(all_fens);
+
+    std::vector<chess::MoveList> all_moves(all.size());
+    for (std::size_t index = 0; index < all.size(); ++index) {
+        chess::movegen::generateAllMoves(*all[index], all_moves[index]);
+    }
+
+    auto scratch = std::make_unique<chess::Board>();
+    Run("parse_fen", options, results, [&] {
+        for (const auto fen : all_fens) {
+            scratch->parseFen(fen);
+        }
+        g_sink = g_sink + scratch->posKey();
+        return all_fens.size();
+    });
+
+    Run("position_key_full", options, results, [&] {
+        std::uint64_t checksum = 0;
+        for (const auto& board : all) {
+            checksum ^= chess::hash::generatePositionKey(*board);
+        }
+        g_sink = g_sink + checksum;
+        return all.size();
+    });
+
+    // Includes the incremental key update of every move.
+    Run("make_take", options, results, [&] { return MakeTake(all, all_moves); });
+
+    Run("movegen_opening", options, results, [&] { return MoveGen(opening); });
+    Run("movegen_middlegame", options, results, [&] { return MoveGen(middlegame); });
+    Run("movegen_endgame", options, results, [&] { return MoveGen(endgame); });
+
+    Run("captures_middlegame", options, results, [&] {
+        chess::MoveList list;
+        std::uint64_t checksum = 0;
+        for (const auto& board : middlegame) {
+            chess::movegen::generateAllCaptures(*board, list);
+            checksum += static_cast<std::uint64_t>(list.size());
+        }
+        g_sink = g_sink + checksum;
+        return middlegame.size();
+    });
+
+    Run("is_square_attacked", options, results, [&] {
+        std::uint64_t checksum = 0;
+        for (const auto& board : middlegame) {
+            for (int sq = 0; sq < 64; ++sq) {
+                checksum += board->isSquareAttacked(static_cast<chess::Square>(sq), chess::Color::White) ? 1 : 0;
+                checksum += board->isSquareAttacked(static_cast<chess::Square>(sq), chess::Color::Black) ? 1 : 0;
+            }
+        }
+        g_sink = g_sink + checksum;
+        return middlegame.size() * 128;
+    });
+
+    Run("evaluate", options, results, [&] {
+        std::uint64_t checksum = 0;
+        for (const auto& board : all) {
+            checksum += static_cast<std::uint64_t>(chess::eval::evaluate(*board));
+        }
+        g_sink = g_sink + checksum;
+        return all.size();
+    });
+
+    // The same positions through the batch evaluator, one thread.
+    chess::eval::BatchEvaluator evaluator;
+    std::vector<chess::Position> positions;
+    positions.reserve(all.size());
+    for (const auto& board : all) {
+        positions.push_back(board->position());
+    }
+    std::vector<int> scores(positions.size());
+    Run("evaluate_batch", options, results, [&] {
+        evaluator.evaluate(positions, scores);
+        std::uint64_t checksum = 0;
+        for (const int score : scores) {
+            checksum += static_cast<std::uint64_t>(score);
+        }
+        g_sink = g_sink + checksum;
+        return positions.size();
+    });
+
+    // Random keys over a table far larger than the caches, as in search.
+    std::array<std::uint64_t, kTableBatch> keys{};
+    std::uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (auto& key : keys) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        key = seed;
+    }
+    const chess::Move move = all_moves[0][0];
+
+    Run("tt_store", options, results, [&] {
+        int depth = 1;
+        for (const auto key : keys) {
+            table.store(key, 0, move, 10, chess::HashFlag::Exact, depth);
+            depth = depth % 16 + 1;
+        }
+        return keys.size();
+    });
+
+    Run("tt_probe", options, results, [&] {
+        std::uint64_t checksum = 0;
+        for (const auto key : keys) {
+            chess::Move found{};
+            int score = 0;
+            checksum += table.probe(key, 0, found, score, -chess::kInfinite, chess::kInfinite, 1) ? 1 : 0;
+            checksum += found.value();
+        }
+        g_sink = g_sink + checksum;
+        return keys.size();
+    });
+
+    // Per node, whole fixed-depth searches; allocs/op should stay at zero.
+    auto searcher = std::make_unique<chess::Board>();
+    searcher->shareHashTable(&table);
+    searcher->evalCache().init(chess::kDefaultEvalCache);
+    chess::SearchInfo info;
+    info.setPollInput(false);
+    info.setPostThinking(false);
+    Run("search_middlegame", options, results, [&] {
+        std::uint64_t nodes = 0;
+        for (const auto fen : kMiddlegame) {
+            searcher->parseFen(fen);
+            chess::search::SearchLimits limits;
+            limits.depth = kSearchDepth;
+            chess::search::applyLimits(limits, info);
+            g_sink = g_sink + chess::search::searchPosition(*searcher, info).value();
+            nodes += static_cast<std::uint64_t>(info.nodes());
+        }
+        return nodes;
+    });
+}
+
+bool ParseArgs(std::span<char*> args, Options& options) {
+    for (std::size_t index = 1; index + 1 < args.size(); index += 2) {
+        const std::string_view key = args[index];
+        const std::string_view value = args[index + 1];
+        bool ok = true;
+        if (key == "filter") {
+            options.filter = value;
+        } else if (key == "ms") {
+            const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), options.minMs);
+            ok = ec == std::errc{} && ptr == value.data() + value.size() && options.minMs > 0;
+        } else if (key == "format") {
+            ok = value == "text" || value == "json";
+            options.json = value == "json";
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << std::format("chess_bench: bad option {} {}\n", key, value);
+            return false;
+        }
+    }
+    if (args.size() % 2 == 0) {
+        std::cerr << std::format("chess_bench: missing value for {}\n", args.back());
+        return false;
+    }
+    return true;
+}
+
+void PrintJson(std::span<const Result> results) {
+    std::cout << std::format("{{\n  \"mode\": \"{}\",\n  \"isa\": \"{}\",\n  \"benchmarks\": [\n",
+                             CHESS_COPY_MAKE ? "copy-make" : "make/unmake",
+                             chess::cpu::isaName(chess::cpu::isa()));
+    for (std::size_t index = 0; index < results.size(); ++index) {
+        const Result& result = results[index];
+        std::cout << std::format(
+            "    {{\"name\": \"{}\", \"ops\": {}, \"ns_per_op\": {:.2f}, \"allocs_per_op\": {:.4f}}}{}\n",
+            result.name, result.ops, result.nsPerOp, result.allocsPerOp, index + 1 < results.size() ? "," : "");
+    }
+    std::cout << "  ]\n}\n";
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!ParseArgs(std::span<char*>{argv, static_cast<std::size_t>(argc)}, options)) {
+        return 1;
+    }
+
+    chess::internal::initializeAll();
+
+    // HashTable::init reports to stdout, which would corrupt the JSON.
+    std::streambuf* const stdout_buffer = std::cout.rdbuf();
+    if (options.json) {
+        std::cout.rdbuf(nullptr);
+    }
+    std::cout << std::format("isa {}\n", chess::cpu::isaName(chess::cpu::isa()));
+    std::vector<Result> results;
+    RunAll(options, results);
+    std::cout.rdbuf(stdout_buffer);
+    std::cout.clear();
+
+    if (options.json) {
+        PrintJson(results);
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Parse and write throughput of the FEN/EPD streaming reader:
+//   fen_bench <file.epd|file.fen>
+// Every record is also written back with fen::write and reparsed to check
+// that the two agree.
+
+#include <array>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <memory>
+
+#include "chess/fen.hpp"
+#include "chess/internal/init.hpp"
+#include "chess/mapped_file.hpp"
+#include "chess/misc.hpp"
+#include "chess/position.hpp"
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: fen_bench <file>\n";
+        return 1;
+    }
+
+    chess::internal::initializeAll();
+
+    chess::MappedFile file;
+    if (!file.open(argv[1])) {
+        std::cerr << std::format("cannot map {}\n", argv[1]);
+        return 1;
+    }
+
+    auto record = std::make_unique<chess::fen::EpdRecord>();
+    chess::fen::EpdReader reader(file.data());
+    std::uint64_t records = 0;
+    std::uint64_t checksum = 0;
+
+    const int start = chess::misc::getTimeMs();
+    while (reader.next(*record)) {
+        ++records;
+        checksum ^= record->position.posKey();
+    }
+    const int parse_ms = chess::misc::getTimeMs() - start;
+
+    // Second pass: write each position and parse it back.
+    auto copy = std::make_unique<chess::Position>();
+    std::array<char, chess::fen::kMaxFenLength> buffer;
+    std::uint64_t mismatches = 0;
+    chess::fen::EpdReader round_trip(file.data());
+
+    const int write_start = chess::misc::getTimeMs();
+    while (round_trip.next(*record)) {
+        const std::size_t length = chess::fen::write(record->position, record->fullMove, buffer);
+        if (chess::fen::parse({buffer.data(), length}, *copy) == 0 ||
+            copy->posKey() != record->position.posKey()) {
+            ++mismatches;
+        }
+    }
+    const int write_ms = chess::misc::getTimeMs() - write_start;
+
+    const auto per_second = [records](int ms) { return records * 1000 / static_cast<std::uint64_t>(ms > 0 ? ms : 1); };
+    std::cout << std::format("{} records, {} bad lines, {} bytes, key checksum {:016X}\n", records,
+                             reader.errors(), file.size(), checksum);
+    std::cout << std::format("parse      {} ms ({} positions/s)\n", parse_ms, per_second(parse_ms));
+    std::cout << std::format("write+parse {} ms ({} positions/s), {} mismatches\n", write_ms,
+                             per_second(write_ms), mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
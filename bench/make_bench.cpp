@@ -0,0 +1,108 @@
+// Compares the move-undo strategies selected by CHESS_COPY_MAKE on perft and
+// on fixed-depth search. Build both variants and run them on the same machine:
+//   make_bench_unmake [perft depth] [search depth]
+//   make_bench_copy   [perft depth] [search depth]
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "chess/board.hpp"
+#include "chess/internal/init.hpp"
+#include "chess/misc.hpp"
+#include "chess/perft.hpp"
+#include "chess/position.hpp"
+#include "chess/search.hpp"
+#include "chess/search_info.hpp"
+#include "chess/types.hpp"
+
+namespace {
+constexpr int kDefaultPerftDepth = 5;
+constexpr int kDefaultSearchDepth = 8;
+constexpr int kHashSizeMb = 16;
+
+constexpr std::array<std::string_view, 5> kPositions = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+};
+
+constexpr std::string_view kMode = CHESS_COPY_MAKE ? "copy-make" : "make/unmake";
+
+int ParseArg(std::span<char*> args, std::size_t index, int fallback) {
+    if (index >= args.size()) {
+        return fallback;
+    }
+    const std::string_view arg = args[index];
+    int value = fallback;
+    std::from_chars(arg.data(), arg.data() + arg.size(), value);
+    return value;
+}
+
+[[nodiscard]] std::uint64_t Nps(std::uint64_t nodes, int ms) noexcept {
+    return nodes * 1000 / static_cast<std::uint64_t>(ms > 0 ? ms : 1);
+}
+
+void BenchPerft(chess::Board& board, int depth) {
+    std::uint64_t total_nodes = 0;
+    int total_ms = 0;
+    for (const auto fen : kPositions) {
+        board.parseFen(fen);
+        const int start = chess::misc::getTimeMs();
+        const std::uint64_t nodes = chess::perft::perft(board, depth);
+        const int elapsed = chess::misc::getTimeMs() - start;
+        total_nodes += nodes;
+        total_ms += elapsed;
+        std::cout << std::format("perft  {:>12} nodes {:>6} ms  {}\n", nodes, elapsed, fen);
+    }
+    std::cout << std::format("perft  total {} nodes {} ms {} nps\n\n", total_nodes, total_ms,
+                             Nps(total_nodes, total_ms));
+}
+
+void BenchSearch(chess::Board& board, int depth) {
+    std::uint64_t total_nodes = 0;
+    int total_ms = 0;
+    for (const auto fen : kPositions) {
+        board.parseFen(fen);
+
+        chess::SearchInfo info;
+        info.setGameMode(chess::GameMode::Console);
+        info.setPollInput(false);
+        info.setDepth(depth);
+        info.setStartTime(chess::misc::getTimeMs());
+
+        chess::search::searchPosition(board, info);
+        const int elapsed = chess::misc::getTimeMs() - info.startTime();
+        const auto nodes = static_cast<std::uint64_t>(info.nodes());
+        total_nodes += nodes;
+        total_ms += elapsed;
+        std::cout << std::format("search {:>12} nodes {:>6} ms  {}\n", nodes, elapsed, fen);
+    }
+    std::cout << std::format("search total {} nodes {} ms {} nps\n", total_nodes, total_ms,
+                             Nps(total_nodes, total_ms));
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::span<char*> args{argv, static_cast<std::size_t>(argc)};
+    const int perft_depth = ParseArg(args, 1, kDefaultPerftDepth);
+    const int search_depth = ParseArg(args, 2, kDefaultSearchDepth);
+
+    chess::internal::initializeAll();
+
+    auto board = std::make_unique<chess::Board>();
+    board->hashTable().init(kHashSizeMb);
+
+    std::cout << std::format("mode {} (sizeof(Position) = {} bytes)\n\n", kMode,
+                             sizeof(chess::Position));
+    BenchPerft(*board, perft_depth);
+    BenchSearch(*board, search_depth);
+    return 0;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+namespace chess::allocations {
+
+// Heap allocations made by the calling thread so far. Defined by the
+// chess_allocations object library, which replaces the global operator new
+// with a counting one; only benchmarks and tests link it, since every
+// allocation pays for the count.
+[[nodiscard]] std::uint64_t count() noexcept;
+
+} // namespace chess::allocations
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "chess/cpu.hpp"
+#include "chess/types.hpp"
+
+namespace chess::attacks {
+
+// Fancy magic bitboard entry: the relevant occupancy is hashed into a per-square
+// slice of a shared attack table. With fast PEXT the slice is instead indexed
+// by the occupancy bits under the mask, packed; both index 2^popcount(mask)
+// entries, so the slices are the same either way.
+struct Magic {
+    Bitboard mask;
+    Bitboard magic;
+    const Bitboard* attacks;
+    unsigned shift;
+
+    [[nodiscard]] unsigned index(Bitboard occupied) const noexcept {
+        if (cpu::usePext()) {
+            return static_cast<unsigned>(cpu::pext(occupied, mask));
+        }
+        return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+    }
+};
+
+void init() noexcept;
+
+extern std::array<Bitboard, 64> g_knightAttacks;
+extern std::array<Bitboard, 64> g_kingAttacks;
+extern std::array<std::array<Bitboard, 64>, 2> g_pawnAttacks;
+extern std::array<Magic, 64> g_rookMagics;
+extern std::array<Magic, 64> g_bishopMagics;
+extern std::array<std::array<Bitboard, 64>, 64> g_between;
+extern std::array<std::array<Bitboard, 64>, 64> g_line;
+
+[[nodiscard]] inline Bitboard knight(Square sq) noexcept {
+    return g_knightAttacks[static_cast<int>(sq)];
+}
+
+[[nodiscard]] inline Bitboard king(Square sq) noexcept {
+    return g_kingAttacks[static_cast<int>(sq)];
+}
+
+// Squares attacked by a pawn of the given color standing on sq.
+[[nodiscard]] inline Bitboard pawn(Color color, Square sq) noexcept {
+    return g_pawnAttacks[static_cast<int>(color)][static_cast<int>(sq)];
+}
+
+[[nodiscard]] inline Bitboard bishop(Square sq, Bitboard occupied) noexcept {
+    const Magic& entry = g_bishopMagics[static_cast<int>(sq)];
+    return entry.attacks[entry.index(occupied)];
+}
+
+[[nodiscard]] inline Bitboard rook(Square sq, Bitboard occupied) noexcept {
+    const Magic& entry = g_rookMagics[static_cast<int>(sq)];
+    return entry.attacks[entry.index(occupied)];
+}
+
+[[nodiscard]] inline Bitboard queen(Square sq, Bitboard occupied) noexcept {
+    return bishop(sq, occupied) | rook(sq, occupied);
+}
+
+// Squares strictly between two aligned squares, or 0 if they are not aligned.
+[[nodiscard]] inline Bitboard between(Square from, Square to) noexcept {
+    return g_between[static_cast<int>(from)][static_cast<int>(to)];
+}
+
+// Full board line through two aligned squares, or 0 if they are not aligned.
+[[nodiscard]] inline Bitboard line(Square first, Square second) noexcept {
+    return g_line[static_cast<int>(first)][static_cast<int>(second)];
+}
+
+} // namespace chess::attacks
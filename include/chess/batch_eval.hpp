@@ -0,0 +1,49 @@
+#pragma once
+
+#include <barrier>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace chess {
+
+class Position;
+
+namespace eval {
+
+// Scores many positions with evaluate(), with no search and no Board, split
+// across a fixed set of threads that each run evaluateLanes over their share.
+// The threads are started once and reused by every call, so small batches do
+// not pay for thread creation. Calls are made from one thread at a time;
+// eval::evaluateBatch shares one evaluator between callers.
+class BatchEvaluator {
+public:
+    // threads includes the calling thread, which takes a share of each batch.
+    explicit BatchEvaluator(int threads = 1);
+    ~BatchEvaluator();
+
+    BatchEvaluator(const BatchEvaluator&) = delete;
+    BatchEvaluator& operator=(const BatchEvaluator&) = delete;
+
+    [[nodiscard]] int threads() const noexcept { return threads_; }
+
+    // evaluate() of every position into out, which must be the same size.
+    // Each thread scores one contiguous range of whole batches.
+    void evaluate(std::span<const Position> positions, std::span<int> out) noexcept;
+
+private:
+    void scoreRange(int index) const noexcept;
+
+    int threads_;
+    std::vector<std::thread> workers_;
+    // Every thread meets at start_ before a batch and at done_ after it.
+    std::barrier<> start_;
+    std::barrier<> done_;
+    std::span<const Position> positions_;
+    std::span<int> out_;
+    bool quit_ = false;
+};
+
+} // namespace eval
+
+} // namespace chess
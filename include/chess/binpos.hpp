@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <vector>
+
+#include "chess/mapped_file.hpp"
+#include "chess/move.hpp"
+#include "chess/types.hpp"
+
+namespace chess {
+
+class Board;
+class Position;
+
+namespace binpos {
+
+// Game outcome from White's point of view.
+enum class GameResult : std::uint8_t { BlackWin = 0, Draw = 1, WhiteWin = 2 };
+
+// 32-byte position record. Pieces are stored as 4-bit Piece codes in
+// occupancy order (lowest square first, low nibble first), which fits the 32
+// men of any legal position. Score is from the side to move's point of view.
+// Files are plain arrays of records in native (little-endian) byte order, so
+// they can be concatenated, split and shuffled with ordinary tools.
+class PackedPosition {
+public:
+    [[nodiscard]] Bitboard occupancy() const noexcept { return occupancy_; }
+    [[nodiscard]] Color side() const noexcept { return (state_ & kSideBit) != 0 ? Color::Black : Color::White; }
+    [[nodiscard]] int castlePerm() const noexcept { return (state_ >> kCastleShift) & 0xF; }
+    [[nodiscard]] Square enPas() const noexcept { return static_cast<Square>(enPas_); }
+    [[nodiscard]] int fiftyMove() const noexcept { return fiftyMove_; }
+
+    [[nodiscard]] std::optional<int> score() const noexcept {
+        return (extras_ & kHasScore) != 0 ? std::optional<int>(score_) : std::nullopt;
+    }
+    [[nodiscard]] std::optional<GameResult> result() const noexcept {
+        return (extras_ & kHasResult) != 0
+                   ? std::optional<GameResult>(static_cast<GameResult>(extras_ & kResultMask))
+                   : std::nullopt;
+    }
+    [[nodiscard]] std::optional<Move> bestMove() const noexcept {
+        return (extras_ & kHasMove) != 0 ? std::optional<Move>(Move(move_)) : std::nullopt;
+    }
+
+    void setScore(int score) noexcept;
+    void setResult(GameResult result) noexcept;
+    void setBestMove(Move move) noexcept;
+
+    friend std::optional<PackedPosition> pack(const Position& pos) noexcept;
+    friend bool unpack(const PackedPosition& packed, Position& pos) noexcept;
+
+private:
+    static constexpr std::uint8_t kSideBit = 0x01;
+    static constexpr int kCastleShift = 1;
+    static constexpr std::uint8_t kResultMask = 0x03;
+    static constexpr std::uint8_t kHasScore = 0x04;
+    static constexpr std::uint8_t kHasResult = 0x08;
+    static constexpr std::uint8_t kHasMove = 0x10;
+
+    Bitboard occupancy_ = 0;
+    std::array<std::uint8_t, 16> pieces_{};
+    std::int16_t score_ = 0;
+    std::uint16_t move_ = 0;
+    std::uint8_t state_ = 0;
+    std::uint8_t enPas_ = static_cast<std::uint8_t>(Square::NoSquare);
+    std::uint8_t fiftyMove_ = 0;
+    std::uint8_t extras_ = 0;
+};
+
+static_assert(sizeof(PackedPosition) == 32);
+
+// The fifty-move count saturates at 255. Positions with more than 32 men
+// cannot be packed and give no record.
+[[nodiscard]] std::optional<PackedPosition> pack(const Position& pos) noexcept;
+[[nodiscard]] std::optional<PackedPosition> pack(const Board& board) noexcept;
+// Returns false if the record does not describe a valid position, including
+// castling rights or an en passant square its placement contradicts.
+bool unpack(const PackedPosition& packed, Position& pos) noexcept;
+bool unpack(const PackedPosition& packed, Board& board) noexcept;
+
+// Appends records to a file through a fixed buffer.
+class BinaryPositionWriter {
+public:
+    BinaryPositionWriter() = default;
+    ~BinaryPositionWriter() { close(); }
+
+    BinaryPositionWriter(const BinaryPositionWriter&) = delete;
+    BinaryPositionWriter& operator=(const BinaryPositionWriter&) = delete;
+
+    // Truncates the file unless append is set.
+    bool open(const char* path, bool append = false) noexcept;
+    bool write(const PackedPosition& record) noexcept;
+    bool flush() noexcept;
+    bool close() noexcept;
+
+    [[nodiscard]] bool isOpen() const noexcept { return file_ != nullptr; }
+    [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+
+private:
+    static constexpr std::size_t kBufferRecords = 4096;
+
+    std::FILE* file_ = nullptr;
+    std::vector<PackedPosition> buffer_;
+    std::uint64_t count_ = 0;
+    bool failed_ = false;
+};
+
+// Reads records from a memory-mapped file. A trailing partial record is ignored.
+class BinaryPositionReader {
+public:
+    bool open(const char* path) noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept { return file_.size() / sizeof(PackedPosition); }
+    [[nodiscard]] PackedPosition at(std::size_t index) const noexcept;
+    // Sequential access; returns false at end of file.
+    bool next(PackedPosition& record) noexcept;
+    void rewind() noexcept { index_ = 0; }
+
+private:
+    MappedFile file_;
+    std::size_t index_ = 0;
+};
+
+} // namespace binpos
+
+} // namespace chess
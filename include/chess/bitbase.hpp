@@ -0,0 +1,11 @@
+#pragma once
+
+#include "chess/types.hpp"
+
+namespace chess::bitbase {
+
+// Whether strong, the side with the pawn, wins king and pawn against king
+// with best play. A table lookup; the position must be legal.
+[[nodiscard]] bool kpkWin(Color strong, Square strongKing, Square pawn, Square weakKing, Color sideToMove) noexcept;
+
+} // namespace chess::bitbase
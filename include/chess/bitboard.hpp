@@ -1,11 +1,12 @@
 #pragma once
 
 #include <array>
+#include <bit>
 #include <cstdint>
 
+#include "chess/cpu.hpp"
 #include "chess/types.hpp"
 
-
 namespace chess::bitboard {
 
 inline constexpr std::array<int, 64> kBitTable = {
@@ -14,8 +15,20 @@ inline constexpr std::array<int, 64> kBitTable = {
     46, 27, 56, 16, 7,  39, 48, 24, 59, 14, 12, 55, 38, 28, 58, 20, 37, 17, 36, 8};
 
 void print(Bitboard bitboard) noexcept;
-int popBit(Bitboard& bitboard) noexcept;
-int countBits(Bitboard bitboard) noexcept;
+
+// Removes the lowest set bit and returns its square, or -1 if empty.
+inline int popBit(Bitboard& bitboard) noexcept {
+    if (bitboard == 0) {
+        return -1;
+    }
+    const int index = std::countr_zero(bitboard);
+    bitboard &= bitboard - 1;
+    return index;
+}
+
+inline int countBits(Bitboard bitboard) noexcept {
+    return cpu::popcount(bitboard);
+}
 
 inline void clearBit(Bitboard& bb, int sq) noexcept {
     bb &= ~(1ULL << sq);
@@ -3,35 +3,20 @@
 #include "chess/types.hpp"
 #include "chess/move.hpp"
 #include "chess/hash.hpp"
+#include "chess/position.hpp"
 #include <array>
 #include <cstdint>
+#include <string>
 #include <string_view>
 
 namespace chess {
 
-class Undo {
-public:
-    Undo() noexcept : move_(kNoMove), castlePerm_(0), enPas_(Square::NoSquare), fiftyMove_(0), posKey_(0) {}
-
-    [[nodiscard]] int move() const noexcept { return move_; }
-    [[nodiscard]] int castlePerm() const noexcept { return castlePerm_; }
-    [[nodiscard]] Square enPas() const noexcept { return enPas_; }
-    [[nodiscard]] int fiftyMove() const noexcept { return fiftyMove_; }
-    [[nodiscard]] std::uint64_t posKey() const noexcept { return posKey_; }
-
-    void setMove(int move) noexcept { move_ = move; }
-    void setCastlePerm(int perm) noexcept { castlePerm_ = perm; }
-    void setEnPas(Square sq) noexcept { enPas_ = sq; }
-    void setFiftyMove(int move) noexcept { fiftyMove_ = move; }
-    void setPosKey(std::uint64_t key) noexcept { posKey_ = key; }
-
-private:
-    int move_;
-    int castlePerm_;
-    Square enPas_;
-    int fiftyMove_;
-    std::uint64_t posKey_;
-};
+// CHESS_COPY_MAKE selects how moves are undone. 0 (default): one Position
+// updated in place, with an Undo record per ply. 1: a preallocated stack of
+// Positions, where each ply copies the parent and takeMove just pops.
+#ifndef CHESS_COPY_MAKE
+#define CHESS_COPY_MAKE 0
+#endif
 
 class Board {
 public:
@@ -40,89 +25,124 @@ public:
 
     Board(const Board&) = delete;
     Board& operator=(const Board&) = delete;
-    Board(Board&&) noexcept = default;
-    Board& operator=(Board&&) noexcept = default;
+    Board(Board&&) = delete;
+    Board& operator=(Board&&) = delete;
 
     void reset() noexcept;
     bool parseFen(std::string_view fen) noexcept;
+    [[nodiscard]] std::string toFen() const;
+    // Starts a new game from pos, as parseFen does from text.
+    void setPosition(const Position& position) noexcept;
     void print() const noexcept;
-    void updateListsMaterial() noexcept;
-    bool checkBoard() const noexcept;
+    void updateListsMaterial() noexcept { pos().updateListsMaterial(); }
+    bool checkBoard() const noexcept { return pos().checkBoard(); }
     void mirror() noexcept;
 
-    [[nodiscard]] Piece pieceAt(Square sq) const noexcept { return pieces_[static_cast<int>(sq)]; }
-    [[nodiscard]] Bitboard pawns(Color color) const noexcept { return pawns_[static_cast<int>(color)]; }
-    [[nodiscard]] Square kingSquare(Color color) const noexcept { return kingSq_[static_cast<int>(color)]; }
-    [[nodiscard]] Color side() const noexcept { return side_; }
-    [[nodiscard]] Square enPas() const noexcept { return enPas_; }
-    [[nodiscard]] int fiftyMove() const noexcept { return fiftyMove_; }
+    [[nodiscard]] const Position& position() const noexcept { return pos(); }
+
+    [[nodiscard]] Piece pieceAt(Square sq) const noexcept { return pos().pieceAt(sq); }
+    [[nodiscard]] Bitboard pieces(Piece pce) const noexcept { return pos().pieces(pce); }
+    [[nodiscard]] Bitboard pieces(Color color, PieceType type) const noexcept { return pos().pieces(color, type); }
+    [[nodiscard]] Bitboard occupancy(Color color) const noexcept { return pos().occupancy(color); }
+    [[nodiscard]] Bitboard pawns(Color color) const noexcept { return pos().pawns(color); }
+    [[nodiscard]] Square kingSquare(Color color) const noexcept { return pos().kingSquare(color); }
+    [[nodiscard]] Color side() const noexcept { return pos().side(); }
+    [[nodiscard]] Square enPas() const noexcept { return pos().enPas(); }
+    [[nodiscard]] int fiftyMove() const noexcept { return pos().fiftyMove(); }
     [[nodiscard]] int ply() const noexcept { return ply_; }
     [[nodiscard]] int hisPly() const noexcept { return hisPly_; }
-    [[nodiscard]] int castlePerm() const noexcept { return castlePerm_; }
-    [[nodiscard]] std::uint64_t posKey() const noexcept { return posKey_; }
-    [[nodiscard]] int pieceCount(Piece pce) const noexcept { return pceNum_[static_cast<int>(pce)]; }
-    [[nodiscard]] int bigPiece(Color color) const noexcept { return bigPce_[static_cast<int>(color)]; }
-    [[nodiscard]] int majPiece(Color color) const noexcept { return majPce_[static_cast<int>(color)]; }
-    [[nodiscard]] int minPiece(Color color) const noexcept { return minPce_[static_cast<int>(color)]; }
-    [[nodiscard]] int material(Color color) const noexcept { return material_[static_cast<int>(color)]; }
-    [[nodiscard]] Square pieceList(Piece pce, int index) const noexcept { return static_cast<Square>(pList_[static_cast<int>(pce)][index]); }
-    [[nodiscard]] HashTable& hashTable() noexcept { return hashTable_; }
-    [[nodiscard]] const HashTable& hashTable() const noexcept { return hashTable_; }
-    [[nodiscard]] int pvArray(int index) const noexcept { return pvArray_[index]; }
-    [[nodiscard]] int& pvArray(int index) noexcept { return pvArray_[index]; }
+    [[nodiscard]] int castlePerm() const noexcept { return pos().castlePerm(); }
+    [[nodiscard]] std::uint64_t posKey() const noexcept { return pos().posKey(); }
+    [[nodiscard]] int pieceCount(Piece pce) const noexcept { return pos().pieceCount(pce); }
+    [[nodiscard]] int bigPiece(Color color) const noexcept { return pos().bigPiece(color); }
+    [[nodiscard]] int majPiece(Color color) const noexcept { return pos().majPiece(color); }
+    [[nodiscard]] int minPiece(Color color) const noexcept { return pos().minPiece(color); }
+    [[nodiscard]] int material(Color color) const noexcept { return pos().material(color); }
+    [[nodiscard]] Square pieceList(Piece pce, int index) const noexcept { return pos().pieceList(pce, index); }
+    [[nodiscard]] HashTable& hashTable() noexcept { return sharedHashTable_ != nullptr ? *sharedHashTable_ : hashTable_; }
+    [[nodiscard]] const HashTable& hashTable() const noexcept { return sharedHashTable_ != nullptr ? *sharedHashTable_ : hashTable_; }
+    [[nodiscard]] bool hashTableShared() const noexcept { return sharedHashTable_ != nullptr; }
+    // Never shared: it is small enough to keep one per searching board.
+    [[nodiscard]] EvalCache& evalCache() noexcept { return evalCache_; }
+    [[nodiscard]] Move pvArray(int index) const noexcept { return pvArray_[index]; }
+    [[nodiscard]] Move& pvArray(int index) noexcept { return pvArray_[index]; }
     [[nodiscard]] int searchHistory(Piece pce, Square sq) const noexcept { return searchHistory_[static_cast<int>(pce)][static_cast<int>(sq)]; }
     [[nodiscard]] int& searchHistory(Piece pce, Square sq) noexcept { return searchHistory_[static_cast<int>(pce)][static_cast<int>(sq)]; }
-    [[nodiscard]] int searchKiller(Color color, int depth) const noexcept { return searchKillers_[static_cast<int>(color)][depth]; }
-    [[nodiscard]] int& searchKiller(Color color, int depth) noexcept { return searchKillers_[static_cast<int>(color)][depth]; }
-    [[nodiscard]] const Undo& history(int index) const noexcept { return history_[index]; }
-    [[nodiscard]] Undo& history(int index) noexcept { return history_[index]; }
+    [[nodiscard]] Move searchKiller(int slot, int ply) const noexcept { return searchKillers_[slot][ply]; }
+    [[nodiscard]] Move& searchKiller(int slot, int ply) noexcept { return searchKillers_[slot][ply]; }
+    [[nodiscard]] Piece captured(Move move) const noexcept { return pos().captured(move); }
+    // Key of the position reached at game ply index (index < hisPly()).
+    [[nodiscard]] std::uint64_t historyKey(int index) const noexcept {
+#if CHESS_COPY_MAKE
+        return states_[index].posKey();
+#else
+        return history_[index].posKey();
+#endif
+    }
 
-    void setPieceAt(Square sq, Piece pce) noexcept { pieces_[static_cast<int>(sq)] = pce; }
-    void setPawns(Color color, Bitboard bb) noexcept { pawns_[static_cast<int>(color)] = bb; }
-    void setKingSquare(Color color, Square sq) noexcept { kingSq_[static_cast<int>(color)] = sq; }
-    void setSide(Color side) noexcept { side_ = side; }
-    void setEnPas(Square sq) noexcept { enPas_ = sq; }
-    void setFiftyMove(int move) noexcept { fiftyMove_ = move; }
+    void setPieceAt(Square sq, Piece pce) noexcept { pos().setPieceAt(sq, pce); }
+    void setKingSquare(Color color, Square sq) noexcept { pos().setKingSquare(color, sq); }
+    void setSide(Color side) noexcept { pos().setSide(side); }
+    void setEnPas(Square sq) noexcept { pos().setEnPas(sq); }
+    void setFiftyMove(int move) noexcept { pos().setFiftyMove(move); }
     void setPly(int ply) noexcept { ply_ = ply; }
-    void setHisPly(int ply) noexcept { hisPly_ = ply; }
-    void setCastlePerm(int perm) noexcept { castlePerm_ = perm; }
-    void setPosKey(std::uint64_t key) noexcept { posKey_ = key; }
-    void setPieceCount(Piece pce, int count) noexcept { pceNum_[static_cast<int>(pce)] = count; }
-    void setBigPiece(Color color, int count) noexcept { bigPce_[static_cast<int>(color)] = count; }
-    void setMajPiece(Color color, int count) noexcept { majPce_[static_cast<int>(color)] = count; }
-    void setMinPiece(Color color, int count) noexcept { minPce_[static_cast<int>(color)] = count; }
-    void setMaterial(Color color, int material) noexcept { material_[static_cast<int>(color)] = material; }
-    void setPieceList(Piece pce, int index, Square sq) noexcept { pList_[static_cast<int>(pce)][index] = static_cast<int>(sq); }
+    // Searches through table, which other boards may use concurrently,
+    // instead of this board's own; nullptr switches back.
+    void shareHashTable(HashTable* table) noexcept { sharedHashTable_ = table; }
+    void setCastlePerm(int perm) noexcept { pos().setCastlePerm(perm); }
+    void setPosKey(std::uint64_t key) noexcept { pos().setPosKey(key); }
 
-    bool makeMove(Move move) noexcept;
+    // The move must be legal in the current position: taken from the legal
+    // generator or checked with movegen::isLegal.
+    void makeMove(Move move) noexcept;
     void takeMove() noexcept;
     void makeNullMove() noexcept;
     void takeNullMove() noexcept;
-    bool isSquareAttacked(Square sq, Color side) const noexcept;
+    bool isSquareAttacked(Square sq, Color side) const noexcept { return pos().isSquareAttacked(sq, side); }
+    [[nodiscard]] Bitboard attackersTo(Square sq, Bitboard occupied) const noexcept { return pos().attackersTo(sq, occupied); }
+
+    // Side-specialized forms dispatched once per node. For makeMove Us is the
+    // side to move; for takeMove it is the side that made the last move.
+    template <Color Us>
+    void makeMove(Move move) noexcept;
+    template <Color Us>
+    void takeMove() noexcept;
+
+    template <Color By>
+    [[nodiscard]] bool isSquareAttacked(Square sq, Bitboard occupied) const noexcept {
+        return pos().isSquareAttacked<By>(sq, occupied);
+    }
 
 private:
-    std::array<Piece, kBoardSquareCount> pieces_;
-    std::array<Bitboard, 3> pawns_;
-    std::array<Square, 2> kingSq_;
-    Color side_;
-    Square enPas_;
-    int fiftyMove_;
+#if CHESS_COPY_MAKE
+    [[nodiscard]] Position& pos() noexcept { return states_[hisPly_]; }
+    [[nodiscard]] const Position& pos() const noexcept { return states_[hisPly_]; }
+#else
+    [[nodiscard]] Position& pos() noexcept { return pos_; }
+    [[nodiscard]] const Position& pos() const noexcept { return pos_; }
+#endif
+    // Keeps the newer half of a full game history so that a long "position
+    // ... moves" line cannot run past its end; takeMove then only goes back
+    // as far as the oldest ply kept.
+    void dropOldHistory() noexcept;
+
+    // Small per-node members first, ahead of the line-aligned position state.
     int ply_;
     int hisPly_;
-    int castlePerm_;
-    std::uint64_t posKey_;
-    std::array<int, 13> pceNum_;
-    std::array<int, 2> bigPce_;
-    std::array<int, 2> majPce_;
-    std::array<int, 2> minPce_;
-    std::array<int, 2> material_;
+    // Game ply of the position parseFen loaded, for the FEN fullmove number.
+    int startPly_;
+    HashTable* sharedHashTable_ = nullptr;
+    EvalCache evalCache_;
+#if CHESS_COPY_MAKE
+    std::array<Position, kMaxGameMoves> states_;
+#else
+    Position pos_;
     std::array<Undo, kMaxGameMoves> history_;
-    std::array<std::array<int, 10>, 13> pList_;
+#endif
     HashTable hashTable_;
-    std::array<int, kMaxDepth> pvArray_;
+    std::array<Move, kMaxDepth> pvArray_;
     std::array<std::array<int, kBoardSquareCount>, 13> searchHistory_;
-    std::array<std::array<int, kMaxDepth>, 2> searchKillers_;
+    std::array<std::array<Move, kMaxDepth>, 2> searchKillers_;
 };
 
 } // namespace chess
-
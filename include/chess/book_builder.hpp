@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+#include "chess/polybook.hpp"
+
+namespace chess::polybook {
+
+struct BuildOptions {
+    // PGN archive.
+    std::string input;
+    std::string output = kDefaultBook;
+    int threads = 1;
+    // Only the first maxPly plies of each game enter the book.
+    int maxPly = 24;
+    // Moves played in fewer games than this are left out.
+    int minGames = 1;
+};
+
+// Replays every finished game of the archive and writes a book whose entry
+// weights are 2 * wins + draws for the side making the move. Returns false
+// if the archive cannot be read or the book cannot be written.
+bool build(const BuildOptions& options);
+
+} // namespace chess::polybook
@@ -52,8 +52,8 @@ concept MoveType = requires(T move) {
     { move.value() } -> std::convertible_to<int>;
     { move.from() } -> BoardSquare;
     { move.to() } -> BoardSquare;
-    { move.captured() } -> ChessPiece;
-    { move.promoted() } -> ChessPiece;
+    { move.flag() } -> std::same_as<MoveFlag>;
+    { move.promoted() } -> std::same_as<PieceType>;
     { move.isCapture() } -> std::convertible_to<bool>;
     { move.isPromotion() } -> std::convertible_to<bool>;
     { move.isCastle() } -> std::convertible_to<bool>;
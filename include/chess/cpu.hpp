@@ -0,0 +1,102 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <string_view>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace chess::cpu {
+
+// Instruction set levels the bit kernels are dispatched on. Each level
+// includes the ones before it.
+enum class Isa : std::uint8_t {
+    Generic,
+    // SSE4.2 and POPCNT.
+    Sse42,
+    // AVX2 and BMI2, with a PEXT fast enough for slider attacks.
+    Avx2,
+};
+
+struct Features {
+    bool popcnt;
+    bool sse42;
+    bool avx2;
+    bool bmi2;
+    // False on CPUs that microcode PEXT (AMD before Zen 3).
+    bool fastPext;
+};
+
+[[nodiscard]] Features detect() noexcept;
+
+// Picks the level for this process from cpuid. CHESS_ISA=generic|sse4.2|avx2
+// in the environment lowers it, for comparing paths on one machine. Must run
+// before attacks::init, which lays out the slider tables for the level.
+void init() noexcept;
+
+[[nodiscard]] Isa isa() noexcept;
+[[nodiscard]] std::string_view isaName(Isa isa) noexcept;
+
+// Set by init; read by the inline kernels below.
+inline bool g_popcnt = false;
+inline bool g_pext = false;
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define CHESS_X86_ASM 1
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define CHESS_X86_INTRINSICS 1
+#endif
+
+// Builds that target the instruction at compile time (-mpopcnt, -mbmi2)
+// use it unconditionally; others test the flag, which is always predicted.
+[[nodiscard]] inline bool usePopcnt() noexcept {
+#if defined(__POPCNT__)
+    return true;
+#else
+    return g_popcnt;
+#endif
+}
+
+[[nodiscard]] inline bool usePext() noexcept {
+#if defined(__BMI2__)
+    return true;
+#else
+    return g_pext;
+#endif
+}
+
+[[nodiscard]] inline int popcount(std::uint64_t value) noexcept {
+#if defined(__POPCNT__)
+    return std::popcount(value);
+#elif defined(CHESS_X86_ASM)
+    if (g_popcnt) {
+        std::uint64_t count;
+        asm("popcntq %1, %0" : "=r"(count) : "rm"(value) : "cc");
+        return static_cast<int>(count);
+    }
+    return std::popcount(value);
+#elif defined(CHESS_X86_INTRINSICS)
+    return g_popcnt ? static_cast<int>(__popcnt64(value)) : std::popcount(value);
+#else
+    return std::popcount(value);
+#endif
+}
+
+// Only valid when usePext() is true.
+[[nodiscard]] inline std::uint64_t pext(std::uint64_t value, std::uint64_t mask) noexcept {
+#if defined(CHESS_X86_ASM)
+    std::uint64_t result;
+    asm("pextq %2, %1, %0" : "=r"(result) : "r"(value), "rm"(mask));
+    return result;
+#elif defined(CHESS_X86_INTRINSICS)
+    return _pext_u64(value, mask);
+#else
+    static_cast<void>(value);
+    static_cast<void>(mask);
+    return 0;
+#endif
+}
+
+} // namespace chess::cpu
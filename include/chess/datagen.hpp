@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "chess/types.hpp"
+
+namespace chess::datagen {
+
+struct Options {
+    int threads = 1;
+    int games = 1000;
+    // Per-move limits; a non-zero node limit applies on top of the depth.
+    int depth = 8;
+    long nodes = 0;
+    // Uniformly random moves played before recording starts.
+    int randomPlies = 8;
+    // A side is declared the winner after this many consecutive plies with
+    // |score| >= winScore; a draw after drawPlies with |score| <= drawScore
+    // once drawMinPly has been reached.
+    int winScore = 1500;
+    int winPlies = 6;
+    int drawScore = 10;
+    int drawPlies = 12;
+    int drawMinPly = 80;
+    int maxPly = 400;
+    int hashMb = 4;
+    std::uint64_t seed = 1;
+    std::string output = "datagen.bin";
+};
+
+// Plays options.games self-play games across options.threads workers and
+// appends the recorded positions to options.output as binpos records.
+// Returns false if the output file cannot be written.
+bool run(const Options& options);
+
+} // namespace chess::datagen
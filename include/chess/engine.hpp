@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <thread>
+
+#include "chess/move.hpp"
+#include "chess/search.hpp"
+#include "chess/search_info.hpp"
+
+namespace chess {
+
+class Board;
+
+struct SearchResult {
+    Move bestMove;
+    // From the side to move's view, of the last completed iteration.
+    int score = 0;
+    int depth = 0;
+    long nodes = 0;
+    int timeMs = 0;
+    SearchStats stats;
+};
+
+// Result of a search started by Engine::startSearch. Copies share the result.
+class SearchHandle {
+public:
+    SearchHandle() noexcept = default;
+
+    [[nodiscard]] bool valid() const noexcept { return result_.valid(); }
+    [[nodiscard]] bool done() const;
+    // Blocks until the search finishes.
+    const SearchResult& wait() const;
+
+private:
+    friend class Engine;
+    explicit SearchHandle(std::shared_future<SearchResult> result) noexcept : result_(std::move(result)) {}
+
+    std::shared_future<SearchResult> result_;
+};
+
+// The engine as a library: one board, one hash table and at most one
+// search at a time, run on a thread of its own. Methods are called from a
+// single controlling thread; progress callbacks run on the search thread.
+// Calls that change the position first stop and wait for a running search.
+class Engine {
+public:
+    using ProgressCallback = std::function<void(const SearchIteration&)>;
+
+    explicit Engine(int hashMb = 64);
+    ~Engine();
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    // Sets the position from FEN and UCI moves played from it. On failure
+    // the position is left at the last legal move reached.
+    bool setPosition(std::string_view fen, std::span<const std::string_view> moves = {});
+    // Clears the hash table for an unrelated game.
+    void newGame();
+    void setHashSize(int mb);
+    // 0 disables the evaluation cache.
+    void setEvalCacheSize(int mb);
+    // See HashTable::save and HashTable::load.
+    bool saveHash(const char* path);
+    bool loadHash(const char* path);
+
+    // Searches the current position without blocking.
+    SearchHandle startSearch(const search::SearchLimits& limits, ProgressCallback progress = {});
+    // Asks the running search to return its best move so far.
+    void stop() noexcept;
+    // The opponent played the move a limits.ponder search was started on:
+    // the search continues under its time limits, counted from now.
+    void ponderHit() noexcept;
+    // Blocks until the running search, if any, has finished.
+    void wait();
+    [[nodiscard]] bool searching() const noexcept { return searching_.load(std::memory_order_acquire); }
+
+    // Only while no search is running.
+    [[nodiscard]] const Board& board() const noexcept { return *board_; }
+
+private:
+    std::unique_ptr<Board> board_;
+    SearchInfo info_;
+    // Written by the search thread.
+    int completedDepth_ = 0;
+    std::thread worker_;
+    std::atomic<bool> stopRequested_{false};
+    std::atomic<bool> ponderHitRequested_{false};
+    std::atomic<bool> searching_{false};
+};
+
+} // namespace chess
@@ -0,0 +1,91 @@
+// Evaluation weights. `chess tune` writes this file in the same layout; copy
+// its output over this file to adopt tuned values.
+#pragma once
+
+#include <array>
+
+namespace chess::eval::params {
+
+inline constexpr std::array<int, 5> kPieceValue = {100, 325, 325, 550, 1000};
+
+inline constexpr int kPawnIsolated = -10;
+
+inline constexpr std::array<int, 8> kPawnPassed = {0, 5, 10, 20, 35, 60, 100, 200};
+
+inline constexpr int kRookOpenFile = 10;
+
+inline constexpr int kRookSemiOpenFile = 5;
+
+inline constexpr int kQueenOpenFile = 5;
+
+inline constexpr int kQueenSemiOpenFile = 3;
+
+inline constexpr int kBishopPair = 30;
+
+inline constexpr std::array<int, 64> kPawnTable = {
+    0,   0,   0,   0,   0,   0,   0,   0,
+    10,  10,  0,   -10, -10, 0,   10,  10,
+    5,   0,   0,   5,   5,   0,   0,   5,
+    0,   0,   10,  20,  20,  10,  0,   0,
+    5,   5,   5,   10,  10,  5,   5,   5,
+    10,  10,  10,  20,  20,  10,  10,  10,
+    20,  20,  20,  30,  30,  20,  20,  20,
+    0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+inline constexpr std::array<int, 64> kKnightTable = {
+    0,   -10, 0,   0,   0,   0,   -10, 0,
+    0,   0,   0,   5,   5,   0,   0,   0,
+    0,   0,   10,  10,  10,  10,  0,   0,
+    0,   0,   10,  20,  20,  10,  5,   0,
+    5,   10,  15,  20,  20,  15,  10,  5,
+    5,   10,  10,  20,  20,  10,  10,  5,
+    0,   0,   5,   10,  10,  5,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+inline constexpr std::array<int, 64> kBishopTable = {
+    0,   0,   -10, 0,   0,   -10, 0,   0,
+    0,   0,   0,   10,  10,  0,   0,   0,
+    0,   0,   10,  15,  15,  10,  0,   0,
+    0,   10,  15,  20,  20,  15,  10,  0,
+    0,   10,  15,  20,  20,  15,  10,  0,
+    0,   0,   10,  15,  15,  10,  0,   0,
+    0,   0,   0,   10,  10,  0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+inline constexpr std::array<int, 64> kRookTable = {
+    0,   0,   5,   10,  10,  5,   0,   0,
+    0,   0,   5,   10,  10,  5,   0,   0,
+    0,   0,   5,   10,  10,  5,   0,   0,
+    0,   0,   5,   10,  10,  5,   0,   0,
+    0,   0,   5,   10,  10,  5,   0,   0,
+    0,   0,   5,   10,  10,  5,   0,   0,
+    25,  25,  25,  25,  25,  25,  25,  25,
+    0,   0,   5,   10,  10,  5,   0,   0,
+};
+
+inline constexpr std::array<int, 64> kKingOpening = {
+    0,   5,   5,   -10, -10, 0,   10,  5,
+    -30, -30, -30, -30, -30, -30, -30, -30,
+    -50, -50, -50, -50, -50, -50, -50, -50,
+    -70, -70, -70, -70, -70, -70, -70, -70,
+    -70, -70, -70, -70, -70, -70, -70, -70,
+    -70, -70, -70, -70, -70, -70, -70, -70,
+    -70, -70, -70, -70, -70, -70, -70, -70,
+    -70, -70, -70, -70, -70, -70, -70, -70,
+};
+
+inline constexpr std::array<int, 64> kKingEndgame = {
+    -50, -10, 0,   0,   0,   0,   -10, -50,
+    -10, 0,   10,  10,  10,  10,  0,   -10,
+    0,   10,  20,  20,  20,  20,  10,  0,
+    0,   10,  20,  40,  40,  20,  10,  0,
+    0,   10,  20,  40,  40,  20,  10,  0,
+    0,   10,  20,  20,  20,  20,  10,  0,
+    -10, 0,   10,  10,  10,  10,  0,   -10,
+    -50, -10, 0,   0,   0,   0,   -10, -50,
+};
+
+} // namespace chess::eval::params
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "chess/types.hpp"
+
+namespace chess {
+
+class Board;
+class Position;
+
+namespace eval {
+
+// Static evaluation in centipawns from the side to move's point of view.
+int evaluate(const Position& pos) noexcept;
+int evaluate(const Board& board) noexcept;
+
+// evaluate() of every position into out, which must be the same size. For
+// scoring many positions without a search: the positions are split across a
+// thread per core (see BatchEvaluator), and each thread scores its share
+// kBatchLanes at a time with evaluateLanes.
+void evaluateBatch(std::span<const Position> positions, std::span<int> out);
+
+inline constexpr std::size_t kBatchLanes = 16;
+
+// evaluate() of at most kBatchLanes positions, computed term by term across
+// the positions in structure-of-arrays form so that the terms vectorize;
+// AVX2 CPUs run a variant compiled for it.
+void evaluateLanes(std::span<const Position> positions, std::span<int> out) noexcept;
+
+// True for material combinations that cannot be won with best play
+// (ignoring pawns, which the caller checks first).
+bool materialDraw(const Position& pos) noexcept;
+
+// Tunable terms, in the order they appear in eval_params.hpp. The tuner sees
+// them as one flat weight vector with each term at termOffset().
+enum class TermId : std::uint8_t {
+    PieceValue,
+    PawnIsolated,
+    PawnPassed,
+    RookOpenFile,
+    RookSemiOpenFile,
+    QueenOpenFile,
+    QueenSemiOpenFile,
+    BishopPair,
+    PawnTable,
+    KnightTable,
+    BishopTable,
+    RookTable,
+    KingOpening,
+    KingEndgame,
+    Count
+};
+
+struct Term {
+    const char* name;
+    // 1 for scalar terms.
+    int size;
+};
+
+inline constexpr std::array<Term, static_cast<int>(TermId::Count)> kTerms = {{
+    {"kPieceValue", 5},
+    {"kPawnIsolated", 1},
+    {"kPawnPassed", 8},
+    {"kRookOpenFile", 1},
+    {"kRookSemiOpenFile", 1},
+    {"kQueenOpenFile", 1},
+    {"kQueenSemiOpenFile", 1},
+    {"kBishopPair", 1},
+    {"kPawnTable", 64},
+    {"kKnightTable", 64},
+    {"kBishopTable", 64},
+    {"kRookTable", 64},
+    {"kKingOpening", 64},
+    {"kKingEndgame", 64},
+}};
+
+[[nodiscard]] constexpr int termOffset(TermId term) noexcept {
+    int offset = 0;
+    for (int index = 0; index < static_cast<int>(term); ++index) {
+        offset += kTerms[index].size;
+    }
+    return offset;
+}
+
+inline constexpr int kNumParams = termOffset(TermId::Count);
+
+// One non-zero coefficient of the evaluation, White minus Black: evaluate()
+// from White's view is the sum of weight[index] * coeff over a position's
+// features.
+struct Feature {
+    std::uint16_t index;
+    std::int16_t coeff;
+};
+
+// The weights compiled into evaluate(), flattened in TermId order.
+[[nodiscard]] std::array<int, kNumParams> weights() noexcept;
+
+// Replaces features with the position's features, sorted by index. Returns
+// false for positions evaluate() scores from endgame knowledge (material
+// draws and KPK) rather than from the weights.
+bool extractFeatures(const Position& pos, std::vector<Feature>& features);
+
+} // namespace eval
+
+} // namespace chess
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "chess/position.hpp"
+#include "chess/types.hpp"
+
+namespace chess::fen {
+
+// Longest FEN write can produce, including the move counters.
+inline constexpr std::size_t kMaxFenLength = 128;
+
+// Parses the first four FEN fields (placement, side, castling, en passant) and,
+// if present, the halfmove clock and fullmove number. On success returns the
+// number of characters consumed; on failure returns 0 and pos is unspecified.
+// Pieces are added incrementally, so lists, material and key need no second pass.
+// Castling rights without their king and rook at home are dropped; an en
+// passant square with no double-pushed pawn behind it fails the parse.
+std::size_t parse(std::string_view text, Position& pos, int* fullMove = nullptr) noexcept;
+
+// Writes the FEN of pos into out (at least kMaxFenLength chars) without a
+// terminating NUL and returns its length.
+std::size_t write(const Position& pos, int fullMove, std::span<char, kMaxFenLength> out) noexcept;
+[[nodiscard]] std::string toFen(const Position& pos, int fullMove = 1);
+
+// One EPD or FEN line. Opcode operands are views into the source text with
+// quotes stripped; absent opcodes are empty.
+struct EpdRecord {
+    Position position;
+    int fullMove = 1;
+    std::string_view line;
+    std::string_view bm;
+    std::string_view am;
+    std::string_view id;
+    std::string_view c0;
+};
+
+// Streams records out of a text buffer, typically a MappedFile, one line at a
+// time without copying. Blank lines and lines that fail to parse are skipped
+// (and counted).
+class EpdReader {
+public:
+    explicit EpdReader(std::string_view text) noexcept : text_(text) {}
+
+    // Parses the next valid line into record; returns false at end of input.
+    bool next(EpdRecord& record) noexcept;
+
+    [[nodiscard]] std::size_t lineNumber() const noexcept { return lineNumber_; }
+    [[nodiscard]] std::size_t errors() const noexcept { return errors_; }
+
+private:
+    std::string_view text_;
+    std::size_t offset_ = 0;
+    std::size_t lineNumber_ = 0;
+    std::size_t errors_ = 0;
+};
+
+} // namespace chess::fen
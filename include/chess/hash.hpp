@@ -1,77 +1,202 @@
 #pragma once
 
+#include "chess/move.hpp"
 #include "chess/types.hpp"
+#include <atomic>
 #include <cstdint>
 #include <memory>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <xmmintrin.h>
+#endif
+
 namespace chess {
 
 class Board;
+class Position;
 
 namespace hash {
 
+std::uint64_t generatePositionKey(const Position& pos) noexcept;
 std::uint64_t generatePositionKey(const Board& board) noexcept;
 
+// Starts loading address into cache, so that a read shortly after does not
+// wait on memory.
+inline void prefetch(const void* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    static_cast<void>(address);
+#endif
+}
+
 } // namespace hash
 
+// Decoded contents of a table slot.
 class HashEntry {
 public:
-    HashEntry() noexcept : posKey_(0), move_(kNoMove), score_(0), depth_(0), flags_(static_cast<int>(HashFlag::None)) {}
+    HashEntry() noexcept : posKey_(0), move_(kNoMove), score_(0), depth_(0), flags_(static_cast<std::uint8_t>(HashFlag::None)) {}
 
     [[nodiscard]] std::uint64_t posKey() const noexcept { return posKey_; }
-    [[nodiscard]] int move() const noexcept { return move_; }
+    [[nodiscard]] Move move() const noexcept { return move_; }
     [[nodiscard]] int score() const noexcept { return score_; }
     [[nodiscard]] int depth() const noexcept { return depth_; }
     [[nodiscard]] HashFlag flags() const noexcept { return static_cast<HashFlag>(flags_); }
 
     void setPosKey(std::uint64_t key) noexcept { posKey_ = key; }
-    void setMove(int move) noexcept { move_ = move; }
-    void setScore(int score) noexcept { score_ = score; }
-    void setDepth(int depth) noexcept { depth_ = depth; }
-    void setFlags(HashFlag flags) noexcept { flags_ = static_cast<int>(flags); }
+    void setMove(Move move) noexcept { move_ = move; }
+    void setScore(int score) noexcept { score_ = static_cast<std::int16_t>(score); }
+    void setDepth(int depth) noexcept { depth_ = static_cast<std::uint8_t>(depth); }
+    void setFlags(HashFlag flags) noexcept { flags_ = static_cast<std::uint8_t>(flags); }
 
 private:
+    // Scores fit in int16 (|score| <= kInfinite) and depths in uint8 (<= kMaxDepth).
     std::uint64_t posKey_;
-    int move_;
-    int score_;
-    int depth_;
-    int flags_;
+    Move move_;
+    std::int16_t score_;
+    std::uint8_t depth_;
+    std::uint8_t flags_;
+};
+
+static_assert(sizeof(HashEntry) == 16);
+
+// A table slot: the entry packed into one data word, and the key stored
+// XORed with it. Both words are read and written without locks, so several
+// searches can share a table; a slot torn by concurrent stores fails the
+// key check instead of returning another position's data.
+class HashSlot {
+public:
+    // Returns false unless the slot holds key.
+    bool load(std::uint64_t key, HashEntry& entry) const noexcept;
+    void store(const HashEntry& entry) noexcept;
+    void clear() noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+
+private:
+    // Saves and loads the raw words.
+    friend class HashTable;
+
+    std::atomic<std::uint64_t> check_{0};
+    std::atomic<std::uint64_t> data_{0};
 };
 
+static_assert(sizeof(HashSlot) == 16);
+
 class HashTable {
 public:
-    HashTable() noexcept : numEntries_(0), newWrite_(0), overWrite_(0), hit_(0), cut_(0) {}
+    HashTable() noexcept : numEntries_(0) {}
     ~HashTable() = default;
 
     HashTable(const HashTable&) = delete;
     HashTable& operator=(const HashTable&) = delete;
-    HashTable(HashTable&&) noexcept = default;
-    HashTable& operator=(HashTable&&) noexcept = default;
 
     void init(int mb);
     void clear() noexcept;
 
-    [[nodiscard]] int numEntries() const noexcept { return numEntries_; }
-    [[nodiscard]] int newWrite() const noexcept { return newWrite_; }
-    [[nodiscard]] int overWrite() const noexcept { return overWrite_; }
-    [[nodiscard]] int hit() const noexcept { return hit_; }
-    [[nodiscard]] int cut() const noexcept { return cut_; }
+    // Writes the table to path: a header with the slot count, entry format
+    // version and a checksum of the Zobrist keys, then the raw slots.
+    bool save(const char* path) const noexcept;
+    // Replaces the table, size included, with one written by save. Returns
+    // false, leaving the table as it was, if the file cannot be read or was
+    // written with another entry format or key scheme.
+    bool load(const char* path) noexcept;
+
+    // Mate scores are stored relative to the node and converted back using ply.
+    void store(std::uint64_t key, int ply, Move move, int score, HashFlag flags, int depth) noexcept;
+    // Sets move whenever the key matches; returns true if score is usable as a cutoff.
+    bool probe(std::uint64_t key, int ply, Move& move, int& score, int alpha, int beta,
+               int depth) noexcept;
+    [[nodiscard]] Move probePvMove(std::uint64_t key) const noexcept;
+    // Starts loading key's slot into cache ahead of a probe.
+    void prefetch(std::uint64_t key) const noexcept { hash::prefetch(&slot(key)); }
 
-    [[nodiscard]] HashEntry* entries() noexcept { return pTable_.get(); }
-    [[nodiscard]] const HashEntry* entries() const noexcept { return pTable_.get(); }
+    [[nodiscard]] int numEntries() const noexcept { return numEntries_; }
+    [[nodiscard]] int newWrite() const noexcept { return stats_.newWrite.load(std::memory_order_relaxed); }
+    [[nodiscard]] int overWrite() const noexcept { return stats_.overWrite.load(std::memory_order_relaxed); }
+    [[nodiscard]] int hit() const noexcept { return stats_.hit.load(std::memory_order_relaxed); }
+    [[nodiscard]] int cut() const noexcept { return stats_.cut.load(std::memory_order_relaxed); }
 
-    void incrementNewWrite() noexcept { ++newWrite_; }
-    void incrementOverWrite() noexcept { ++overWrite_; }
-    void incrementHit() noexcept { ++hit_; }
-    void incrementCut() noexcept { ++cut_; }
+    void incrementNewWrite() noexcept { bump(stats_.newWrite); }
+    void incrementOverWrite() noexcept { bump(stats_.overWrite); }
+    void incrementHit() noexcept { bump(stats_.hit); }
+    void incrementCut() noexcept { bump(stats_.cut); }
 
 private:
-    std::unique_ptr<HashEntry[]> pTable_;
+    // Counters are approximate on a shared table: a locked increment would
+    // have every search contend for this cache line.
+    struct alignas(64) Stats {
+        std::atomic<int> newWrite{0};
+        std::atomic<int> overWrite{0};
+        std::atomic<int> hit{0};
+        std::atomic<int> cut{0};
+    };
+
+    // Maps the key onto [0, numEntries) with a multiply instead of a
+    // division, which would cost more than the prefetch saves.
+    [[nodiscard]] HashSlot& slot(std::uint64_t key) const noexcept {
+        const auto entries = static_cast<std::uint64_t>(numEntries_);
+#if defined(__SIZEOF_INT128__)
+        __extension__ typedef unsigned __int128 Wide;
+        return pTable_[static_cast<std::size_t>((static_cast<Wide>(key) * entries) >> 64)];
+#elif defined(_MSC_VER) && defined(_M_X64)
+        return pTable_[static_cast<std::size_t>(__umulh(key, entries))];
+#else
+        return pTable_[static_cast<std::size_t>(key % entries)];
+#endif
+    }
+
+    static void bump(std::atomic<int>& counter) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<HashSlot[]> pTable_;
     int numEntries_;
-    int newWrite_;
-    int overWrite_;
-    int hit_;
-    int cut_;
+    Stats stats_;
+};
+
+// Direct-mapped cache of static evaluations, private to one board. Each
+// entry is one word: the key's upper 48 bits over the 16-bit score. Lookups
+// cost far less than evaluate(), so transpositions and re-searches reuse the
+// score instead of recomputing it.
+class EvalCache {
+public:
+    EvalCache() noexcept = default;
+    ~EvalCache() = default;
+
+    EvalCache(const EvalCache&) = delete;
+    EvalCache& operator=(const EvalCache&) = delete;
+
+    // Rounds down to a power of two entries; 0 disables the cache.
+    void init(int mb);
+    void clear() noexcept;
+    [[nodiscard]] bool enabled() const noexcept { return pTable_ != nullptr; }
+
+    // Only valid when enabled().
+    bool probe(std::uint64_t key, int& score) const noexcept {
+        const std::uint64_t entry = pTable_[key & mask_];
+        if ((entry ^ key) & kCheckMask) {
+            return false;
+        }
+        score = static_cast<std::int16_t>(entry & ~kCheckMask);
+        return true;
+    }
+    void store(std::uint64_t key, int score) noexcept {
+        pTable_[key & mask_] = (key & kCheckMask) | static_cast<std::uint16_t>(score);
+    }
+    void prefetch(std::uint64_t key) const noexcept {
+        if (enabled()) {
+            hash::prefetch(&pTable_[key & mask_]);
+        }
+    }
+
+private:
+    static constexpr std::uint64_t kCheckMask = ~std::uint64_t{0xFFFF};
+
+    std::unique_ptr<std::uint64_t[]> pTable_;
+    std::uint64_t mask_ = 0;
 };
 
 } // namespace chess
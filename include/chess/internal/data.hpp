@@ -30,20 +30,14 @@ inline constexpr std::array<int, 64> kMirror64 = {
     8,  9,  10, 11, 12, 13, 14, 15, 0,  1,  2,  3,  4,  5,  6,  7
 };
 
-void initSq120To64() noexcept;
 void initBitMasks() noexcept;
-void initFilesRanksBrd() noexcept;
 void initEvalMasks() noexcept;
 
-extern std::array<int, kBoardSquareCount> g_sq120ToSq64;
-extern std::array<int, 64> g_sq64ToSq120;
 extern std::array<Bitboard, 64> g_setMask;
 extern std::array<Bitboard, 64> g_clearMask;
-extern std::array<std::array<Bitboard, 120>, 13> g_pieceKeys;
+extern std::array<std::array<Bitboard, kBoardSquareCount>, 13> g_pieceKeys;
 extern Bitboard g_sideKey;
 extern std::array<Bitboard, 16> g_castleKeys;
-extern std::array<int, kBoardSquareCount> g_filesBrd;
-extern std::array<int, kBoardSquareCount> g_ranksBrd;
 extern std::array<Bitboard, 8> g_fileBBMask;
 extern std::array<Bitboard, 8> g_rankBBMask;
 extern std::array<Bitboard, 64> g_blackPassedMask;
@@ -66,12 +60,4 @@ extern std::array<Bitboard, 64> g_isolatedMask;
     return kPieceKing[static_cast<int>(p)] != 0;
 }
 
-[[nodiscard]] inline int squareTo64(Square sq120) noexcept {
-    return g_sq120ToSq64[static_cast<int>(sq120)];
-}
-
-[[nodiscard]] inline Square squareTo120(int sq64) noexcept {
-    return static_cast<Square>(g_sq64ToSq120[sq64]);
-}
-
 } // namespace chess::internal
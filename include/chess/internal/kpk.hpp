@@ -0,0 +1,22 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace chess::internal {
+
+// King and pawn against king with White holding the pawn on files A-D,
+// ranks 2-7: one bit per position, set if White wins.
+inline constexpr int kKpkEntries = 64 * 64 * 2 * 4 * 6;
+inline constexpr int kKpkWords = kKpkEntries / 32;
+
+// Squares run A1 = 0 to H8 = 63.
+[[nodiscard]] constexpr int kpkIndex(bool blackToMove, int whiteKing, int blackKing, int pawn) noexcept {
+    return whiteKing | blackKing << 6 | static_cast<int>(blackToMove) << 12 | (pawn & 7) << 13 |
+           (6 - (pawn >> 3)) << 15;
+}
+
+// Solved at build time by tools/kpk_generate.
+extern const std::array<std::uint32_t, kKpkWords> g_kpkBitbase;
+
+} // namespace chess::internal
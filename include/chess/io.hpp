@@ -14,6 +14,7 @@ class MoveList;
 namespace io {
 
 std::string printSquare(Square sq) noexcept;
+// UCI coordinates; "0000", the UCI null move, for no move.
 std::string printMove(Move move) noexcept;
 void printMoveList(const MoveList& list) noexcept;
 std::optional<Move> parseMove(std::string_view str, const Board& board) noexcept;
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace chess {
+
+// Read-only memory mapping of a whole file. The mapping lives as long as the
+// object; views returned by data() must not outlive it.
+class MappedFile {
+public:
+    MappedFile() noexcept = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Returns false if the file cannot be opened or mapped. An empty file
+    // opens successfully with an empty view.
+    bool open(const char* path) noexcept;
+    void close() noexcept;
+
+    [[nodiscard]] bool isOpen() const noexcept { return open_; }
+    [[nodiscard]] std::string_view data() const noexcept { return {data_, size_}; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool open_ = false;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+} // namespace chess
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <format>
+#include <iterator>
+#include <ostream>
+#include <utility>
+
 #include "chess/types.hpp"
 
 namespace chess {
@@ -9,8 +14,16 @@ class SearchInfo;
 namespace misc {
 
 int getTimeMs() noexcept;
+// Reads a pending protocol command into a fixed buffer; longer lines are
+// truncated.
 void readInput(SearchInfo& info) noexcept;
 
+// std::format straight into out's buffer, without a temporary string.
+template <typename... Args>
+void print(std::ostream& out, std::format_string<Args...> format, Args&&... args) {
+    std::format_to(std::ostreambuf_iterator<char>(out), format, std::forward<Args>(args)...);
+}
+
 } // namespace misc
 
 } // namespace chess
@@ -3,39 +3,50 @@
 #include "chess/types.hpp"
 #include <array>
 #include <cstdint>
+#include <utility>
 
 namespace chess {
 
 class Move {
 public:
-    Move() noexcept : move_(kNoMove), score_(0) {}
-    Move(int move, int score = 0) noexcept : move_(move), score_(score) {}
-
-    [[nodiscard]] int value() const noexcept { return move_; }
-    [[nodiscard]] int score() const noexcept { return score_; }
-    [[nodiscard]] int& score() noexcept { return score_; }
-    [[nodiscard]] Square from() const noexcept { return static_cast<Square>(fromSquare(move_)); }
-    [[nodiscard]] Square to() const noexcept { return static_cast<Square>(toSquare(move_)); }
-    [[nodiscard]] Piece captured() const noexcept { return static_cast<Piece>(capturedPiece(move_)); }
-    [[nodiscard]] Piece promoted() const noexcept { return static_cast<Piece>(promotedPiece(move_)); }
-    [[nodiscard]] bool isEnPassant() const noexcept { return (move_ & kMoveFlagEnPassant) != 0; }
-    [[nodiscard]] bool isPawnStart() const noexcept { return (move_ & kMoveFlagPawnStart) != 0; }
-    [[nodiscard]] bool isCastle() const noexcept { return (move_ & kMoveFlagCastle) != 0; }
-    [[nodiscard]] bool isCapture() const noexcept { return (move_ & kMoveFlagCapture) != 0; }
-    [[nodiscard]] bool isPromotion() const noexcept { return (move_ & kMoveFlagPromotion) != 0; }
-
-    [[nodiscard]] bool operator==(const Move& other) const noexcept { return move_ == other.move_; }
-    [[nodiscard]] bool operator!=(const Move& other) const noexcept { return move_ != other.move_; }
-
-    static Move create(int from, int to, int captured, int promoted, int flags) noexcept {
-        return Move(from | (to << 7) | (captured << 14) | (promoted << 20) | flags);
+    constexpr Move() noexcept : move_(kNoMove) {}
+    constexpr Move(int move) noexcept : move_(static_cast<std::uint16_t>(move)) {}
+
+    [[nodiscard]] constexpr int value() const noexcept { return move_; }
+    [[nodiscard]] constexpr Square from() const noexcept { return static_cast<Square>(fromSquare(move_)); }
+    [[nodiscard]] constexpr Square to() const noexcept { return static_cast<Square>(toSquare(move_)); }
+    [[nodiscard]] constexpr MoveFlag flag() const noexcept { return static_cast<MoveFlag>(moveFlag(move_)); }
+    [[nodiscard]] constexpr bool isEnPassant() const noexcept { return flag() == MoveFlag::EnPassant; }
+    [[nodiscard]] constexpr bool isPawnStart() const noexcept { return flag() == MoveFlag::DoublePush; }
+    [[nodiscard]] constexpr bool isCastle() const noexcept {
+        return flag() == MoveFlag::KingCastle || flag() == MoveFlag::QueenCastle;
+    }
+    [[nodiscard]] constexpr bool isCapture() const noexcept { return (moveFlag(move_) & kMoveFlagCapture) != 0; }
+    [[nodiscard]] constexpr bool isPromotion() const noexcept { return (moveFlag(move_) & kMoveFlagPromotion) != 0; }
+
+    // Promotion piece type, or PieceType::None for non-promotions.
+    [[nodiscard]] constexpr PieceType promoted() const noexcept {
+        if (!isPromotion()) {
+            return PieceType::None;
+        }
+        return static_cast<PieceType>((moveFlag(move_) & 0x3) + static_cast<int>(PieceType::Knight));
+    }
+
+    [[nodiscard]] constexpr bool operator==(const Move& other) const noexcept { return move_ == other.move_; }
+    [[nodiscard]] constexpr bool operator!=(const Move& other) const noexcept { return move_ != other.move_; }
+
+    static constexpr Move create(int from, int to, MoveFlag flag = MoveFlag::Quiet) noexcept {
+        return Move(from | (to << 6) | (static_cast<int>(flag) << 12));
     }
 
 private:
-    int move_;
-    int score_;
+    std::uint16_t move_;
 };
 
+static_assert(sizeof(Move) == 2);
+
+// Moves and their ordering scores are kept in parallel arrays so that the move
+// array stays dense; scores are only touched by move ordering.
 class MoveList {
 public:
     MoveList() noexcept : count_(0) {}
@@ -44,22 +55,23 @@ public:
     [[nodiscard]] int size() const noexcept { return count_; }
     [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
 
-    void add(const Move& move) {
+    void add(Move move, int score = 0) noexcept {
         if (count_ < kMaxPositionMoves) {
             moves_[count_] = move;
+            scores_[count_] = score;
             ++count_;
         }
     }
 
-    void add(int move, int score) {
-        if (count_ < kMaxPositionMoves) {
-            moves_[count_] = Move(move, score);
-            ++count_;
-        }
-    }
-
-    [[nodiscard]] const Move& operator[](int index) const noexcept { return moves_[index]; }
+    [[nodiscard]] Move operator[](int index) const noexcept { return moves_[index]; }
     [[nodiscard]] Move& operator[](int index) noexcept { return moves_[index]; }
+    [[nodiscard]] int score(int index) const noexcept { return scores_[index]; }
+    [[nodiscard]] int& score(int index) noexcept { return scores_[index]; }
+
+    void swap(int first, int second) noexcept {
+        std::swap(moves_[first], moves_[second]);
+        std::swap(scores_[first], scores_[second]);
+    }
 
     [[nodiscard]] const Move* begin() const noexcept { return moves_.data(); }
     [[nodiscard]] const Move* end() const noexcept { return moves_.data() + count_; }
@@ -68,8 +80,8 @@ public:
 
 private:
     std::array<Move, kMaxPositionMoves> moves_;
+    std::array<int, kMaxPositionMoves> scores_;
     int count_;
 };
 
 } // namespace chess
-
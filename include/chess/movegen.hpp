@@ -10,9 +10,30 @@ class Move;
 
 namespace movegen {
 
+// The generators emit strictly legal moves. Checkers and pinned pieces are
+// computed once per call; in check only evasions are generated. Captures
+// (promotions that capture included) and quiets (every other move, quiet
+// promotions and castling included) together are all the moves.
 void generateAllMoves(const Board& board, MoveList& list) noexcept;
 void generateAllCaptures(const Board& board, MoveList& list) noexcept;
-bool MoveExists(Board& board, const Move& move) noexcept;
+void generateQuiets(const Board& board, MoveList& list) noexcept;
+
+// Side-specialized generators for callers that already know the side to move;
+// Us must equal board.side().
+template <Color Us>
+void generateAllMoves(const Board& board, MoveList& list) noexcept;
+template <Color Us>
+void generateAllCaptures(const Board& board, MoveList& list) noexcept;
+template <Color Us>
+void generateQuiets(const Board& board, MoveList& list) noexcept;
+
+// Checks a move from elsewhere (the hash table, a killer slot) against the
+// board directly, without generating: the piece on the from square, the
+// destination, the flag, the path of sliders, pawn pushes and castling
+// rights. isLegal also rejects moves that leave the king attacked, so it
+// holds exactly for the moves generateAllMoves would produce.
+[[nodiscard]] bool isPseudoLegal(const Board& board, Move move) noexcept;
+[[nodiscard]] bool isLegal(const Board& board, Move move) noexcept;
 void initMvvLva() noexcept;
 
 } // namespace movegen
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace chess {
+
+// Unbounded multi-producer single-consumer queue (Vyukov). push is wait-free
+// for producers; tryPop must only be called from one consumer thread. A pushed
+// item may briefly be invisible to tryPop while its producer links it in.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head_(new Node{}), tail_(head_.load(std::memory_order_relaxed)) {}
+
+    ~MpscQueue() {
+        Node* node = tail_;
+        while (node != nullptr) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        Node* node = new Node{std::move(value)};
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    bool tryPop(T& value) noexcept {
+        Node* next = tail_->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return false;
+        }
+        value = std::move(next->value);
+        delete tail_;
+        tail_ = next;
+        return true;
+    }
+
+private:
+    struct Node {
+        T value{};
+        std::atomic<Node*> next{nullptr};
+    };
+
+    std::atomic<Node*> head_;
+    Node* tail_;
+};
+
+} // namespace chess
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+#include "chess/types.hpp"
+
+namespace chess {
+
+class Board;
+
+namespace perft {
+
+// Leaf count at the given depth; the last ply is counted from the legal move
+// list size without making the moves.
+std::uint64_t perft(Board& board, int depth) noexcept;
+void perftTest(Board& board, int depth) noexcept;
+
+} // namespace perft
+
+} // namespace chess
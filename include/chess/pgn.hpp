@@ -0,0 +1,69 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "chess/binpos.hpp"
+#include "chess/move.hpp"
+
+namespace chess {
+
+class Board;
+
+namespace pgn {
+
+// One game's text, viewing into the buffer the reader was given.
+struct Game {
+    std::string_view tags;
+    std::string_view movetext;
+};
+
+// Splits PGN text into games: a run of tag-pair lines followed by movetext
+// up to the next tag-pair line.
+class PgnReader {
+public:
+    explicit PgnReader(std::string_view text) noexcept : text_(text) {}
+
+    // Returns false at end of text.
+    bool next(Game& game) noexcept;
+
+private:
+    std::string_view text_;
+    std::size_t pos_ = 0;
+};
+
+// Tokenizes movetext into SAN moves, skipping move numbers, comments,
+// variations and NAGs. Stops at the game termination marker.
+class MovetextReader {
+public:
+    explicit MovetextReader(std::string_view text) noexcept : text_(text) {}
+
+    bool next(std::string_view& san) noexcept;
+
+private:
+    std::string_view text_;
+    std::size_t pos_ = 0;
+};
+
+// Value of a tag pair without its quotes; empty if the tag is absent.
+[[nodiscard]] std::string_view tagValue(std::string_view tags, std::string_view name) noexcept;
+
+// Outcome from the Result tag; nullopt for unfinished games ("*").
+[[nodiscard]] std::optional<binpos::GameResult> result(const Game& game) noexcept;
+
+// Loads the game's start position: its FEN tag, or the standard start.
+bool setup(const Game& game, Board& board) noexcept;
+
+// The legal move san denotes in board's position, or Move{} if there is no
+// such move or it is ambiguous. Accepts check/annotation suffixes, "0-0"
+// castling and long-algebraic forms like "e2-e4".
+[[nodiscard]] Move parseSan(const Board& board, std::string_view san) noexcept;
+
+// Splits text into at most count pieces, each starting at a game, for
+// parsing in parallel.
+[[nodiscard]] std::vector<std::string_view> splitGames(std::string_view text, int count);
+
+} // namespace pgn
+
+} // namespace chess
@@ -1,16 +1,47 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
+
+#include "chess/move.hpp"
+
 namespace chess {
 
 class Board;
 
 namespace polybook {
 
+// Opening books use Polyglot-style records: 16-byte big-endian entries
+// sorted by key, moves in Polyglot encoding (castling as king takes rook).
+// Keys are the engine's posKey rather than Polyglot's, so a book starts with
+// a header record and open() rejects files without it, such as books from
+// Polyglot tools. Books are built with `chess book`.
+struct Entry {
+    std::uint64_t key;
+    std::uint16_t move;
+    std::uint16_t weight;
+    std::uint32_t learn;
+};
+
+inline constexpr const char* kDefaultBook = "chess.book";
+
+// Opens kDefaultBook if it exists.
 void init() noexcept;
 void clean() noexcept;
-int getBookMove(Board& board) noexcept;
+// Replaces the current book; returns false if path cannot be read or is not
+// a book written by writeBook, and says so on stderr for the latter.
+bool open(const char* path) noexcept;
+
+// A weighted random book move for the position, or Move{} if there is none.
+Move getBookMove(Board& board) noexcept;
+
+[[nodiscard]] std::uint16_t encodeMove(Move move) noexcept;
+// The legal move matching a Polyglot move, or Move{}.
+[[nodiscard]] Move decodeMove(const Board& board, std::uint16_t move) noexcept;
+
+// Writes entries, which must already be sorted by key.
+bool writeBook(const char* path, std::span<const Entry> entries) noexcept;
 
 } // namespace polybook
 
 } // namespace chess
-
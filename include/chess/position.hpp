@@ -0,0 +1,162 @@
+#pragma once
+
+#include "chess/attacks.hpp"
+#include "chess/move.hpp"
+#include "chess/types.hpp"
+#include <array>
+#include <cstdint>
+
+namespace chess {
+
+class Undo {
+public:
+    Undo() noexcept
+        : posKey_(0), move_(kNoMove), fiftyMove_(0), captured_(Piece::Empty), castlePerm_(0), enPas_(Square::NoSquare) {}
+
+    [[nodiscard]] Move move() const noexcept { return move_; }
+    [[nodiscard]] Piece captured() const noexcept { return captured_; }
+    [[nodiscard]] int castlePerm() const noexcept { return castlePerm_; }
+    [[nodiscard]] Square enPas() const noexcept { return enPas_; }
+    [[nodiscard]] int fiftyMove() const noexcept { return fiftyMove_; }
+    [[nodiscard]] std::uint64_t posKey() const noexcept { return posKey_; }
+
+    void setMove(Move move) noexcept { move_ = move; }
+    void setCaptured(Piece pce) noexcept { captured_ = pce; }
+    void setCastlePerm(int perm) noexcept { castlePerm_ = static_cast<std::uint8_t>(perm); }
+    void setEnPas(Square sq) noexcept { enPas_ = sq; }
+    void setFiftyMove(int move) noexcept { fiftyMove_ = static_cast<std::uint16_t>(move); }
+    void setPosKey(std::uint64_t key) noexcept { posKey_ = key; }
+
+private:
+    // States the layout guarantees in position.cpp.
+    friend struct PositionLayout;
+
+    std::uint64_t posKey_;
+    Move move_;
+    std::uint16_t fiftyMove_;
+    Piece captured_;
+    std::uint8_t castlePerm_;
+    Square enPas_;
+};
+
+// A game's history is an array of these, one per ply.
+static_assert(sizeof(Undo) == 16);
+
+// The per-ply state of a game: everything make/unmake changes. Board owns one
+// Position (make/unmake) or a stack of them (copy-make). Laid out for the
+// cache: the state every node reads, then the bitboards, fill the first
+// three lines; the mailbox and piece lists, used when pieces move, follow.
+class alignas(64) Position {
+public:
+    Position() noexcept { reset(); }
+
+    void reset() noexcept;
+    void updateListsMaterial() noexcept;
+    bool checkBoard() const noexcept;
+
+    // For state read from outside (FEN, packed records): the castling rights
+    // of perm whose king and rook stand on their home squares, and whether
+    // sq can be the en passant square with side() to move, i.e. it and the
+    // square the pawn came from are empty and the pawn stands beyond it.
+    [[nodiscard]] int supportedCastlePerm(int perm) const noexcept;
+    [[nodiscard]] bool enPassantPossible(Square sq) const noexcept;
+
+    [[nodiscard]] Piece pieceAt(Square sq) const noexcept { return pieces_[static_cast<int>(sq)]; }
+    [[nodiscard]] Bitboard pieces(Piece pce) const noexcept { return pieceBB_[static_cast<int>(pce)]; }
+    [[nodiscard]] Bitboard pieces(Color color, PieceType type) const noexcept { return pieceBB_[static_cast<int>(pieceOf(color, type))]; }
+    [[nodiscard]] Bitboard occupancy(Color color) const noexcept { return occupancy_[static_cast<int>(color)]; }
+    [[nodiscard]] Bitboard pawns(Color color) const noexcept {
+        if (color == Color::Both) {
+            return pieceBB_[static_cast<int>(Piece::WhitePawn)] | pieceBB_[static_cast<int>(Piece::BlackPawn)];
+        }
+        return pieces(color, PieceType::Pawn);
+    }
+    [[nodiscard]] Square kingSquare(Color color) const noexcept { return kingSq_[static_cast<int>(color)]; }
+    [[nodiscard]] Color side() const noexcept { return side_; }
+    [[nodiscard]] Square enPas() const noexcept { return enPas_; }
+    [[nodiscard]] int fiftyMove() const noexcept { return fiftyMove_; }
+    [[nodiscard]] int castlePerm() const noexcept { return castlePerm_; }
+    [[nodiscard]] std::uint64_t posKey() const noexcept { return posKey_; }
+    [[nodiscard]] int pieceCount(Piece pce) const noexcept { return pceNum_[static_cast<int>(pce)]; }
+    [[nodiscard]] int bigPiece(Color color) const noexcept { return bigPce_[static_cast<int>(color)]; }
+    [[nodiscard]] int majPiece(Color color) const noexcept { return majPce_[static_cast<int>(color)]; }
+    [[nodiscard]] int minPiece(Color color) const noexcept { return minPce_[static_cast<int>(color)]; }
+    [[nodiscard]] int material(Color color) const noexcept { return material_[static_cast<int>(color)]; }
+    [[nodiscard]] Square pieceList(Piece pce, int index) const noexcept { return pList_[static_cast<int>(pce)][index]; }
+
+    // Piece removed by the move in this position; moves do not encode it.
+    [[nodiscard]] Piece captured(Move move) const noexcept {
+        if (move.isEnPassant()) {
+            return side_ == Color::White ? Piece::BlackPawn : Piece::WhitePawn;
+        }
+        return move.isCapture() ? pieces_[static_cast<int>(move.to())] : Piece::Empty;
+    }
+
+    void setPieceAt(Square sq, Piece pce) noexcept { pieces_[static_cast<int>(sq)] = pce; }
+    void setKingSquare(Color color, Square sq) noexcept { kingSq_[static_cast<int>(color)] = sq; }
+    void setSide(Color side) noexcept { side_ = side; }
+    void setEnPas(Square sq) noexcept { enPas_ = sq; }
+    void setFiftyMove(int move) noexcept { fiftyMove_ = static_cast<std::uint16_t>(move); }
+    void setCastlePerm(int perm) noexcept { castlePerm_ = static_cast<std::uint8_t>(perm); }
+    void setPosKey(std::uint64_t key) noexcept { posKey_ = key; }
+    void setPieceCount(Piece pce, int count) noexcept { pceNum_[static_cast<int>(pce)] = static_cast<std::uint8_t>(count); }
+    void setBigPiece(Color color, int count) noexcept { bigPce_[static_cast<int>(color)] = static_cast<std::uint8_t>(count); }
+    void setMajPiece(Color color, int count) noexcept { majPce_[static_cast<int>(color)] = static_cast<std::uint8_t>(count); }
+    void setMinPiece(Color color, int count) noexcept { minPce_[static_cast<int>(color)] = static_cast<std::uint8_t>(count); }
+    void setMaterial(Color color, int material) noexcept { material_[static_cast<int>(color)] = material; }
+    void setPieceList(Piece pce, int index, Square sq) noexcept { pList_[static_cast<int>(pce)][index] = sq; }
+
+    // Incremental updates of pieces, bitboards, lists, material and key.
+    void addPiece(Square sq, Piece pce) noexcept;
+    void clearPiece(Square sq) noexcept;
+    void movePiece(Square from, Square to) noexcept;
+    // Adds the side, castling and en passant terms to the key once a position
+    // has been built with addPiece and the state setters.
+    void hashState() noexcept;
+
+    // Apply a legal move for side Us. undoMove reverses it from the saved Undo.
+    template <Color Us>
+    void doMove(Move move) noexcept;
+    template <Color Us>
+    void undoMove(const Undo& undo) noexcept;
+    void doNullMove() noexcept;
+    void undoNullMove(const Undo& undo) noexcept;
+    void saveUndo(Undo& undo, Move move) const noexcept;
+
+    [[nodiscard]] Bitboard attackersTo(Square sq, Bitboard occupied) const noexcept;
+    [[nodiscard]] bool isSquareAttacked(Square sq, Color side) const noexcept;
+
+    template <Color By>
+    [[nodiscard]] bool isSquareAttacked(Square sq, Bitboard occupied) const noexcept {
+        constexpr Color kOther = By == Color::White ? Color::Black : Color::White;
+        const Bitboard queens = pieces(By, PieceType::Queen);
+        return (attacks::pawn(kOther, sq) & pieces(By, PieceType::Pawn)) != 0 ||
+               (attacks::knight(sq) & pieces(By, PieceType::Knight)) != 0 ||
+               (attacks::king(sq) & pieces(By, PieceType::King)) != 0 ||
+               (attacks::bishop(sq, occupied) & (pieces(By, PieceType::Bishop) | queens)) != 0 ||
+               (attacks::rook(sq, occupied) & (pieces(By, PieceType::Rook) | queens)) != 0;
+    }
+
+private:
+    // States the layout guarantees in position.cpp.
+    friend struct PositionLayout;
+
+    std::uint64_t posKey_;
+    // Includes the kings, so it does not fit in 16 bits.
+    std::array<int, 2> material_;
+    std::array<Square, 2> kingSq_;
+    Color side_;
+    Square enPas_;
+    std::uint16_t fiftyMove_;
+    std::uint8_t castlePerm_;
+    std::array<std::uint8_t, 13> pceNum_;
+    std::array<std::uint8_t, 2> bigPce_;
+    std::array<std::uint8_t, 2> majPce_;
+    std::array<std::uint8_t, 2> minPce_;
+    std::array<Bitboard, 13> pieceBB_;
+    std::array<Bitboard, 3> occupancy_;
+    std::array<Piece, kBoardSquareCount> pieces_;
+    std::array<std::array<Square, 10>, 13> pList_;
+};
+
+} // namespace chess
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "chess/binpos.hpp"
+#include "chess/mapped_file.hpp"
+#include "chess/move.hpp"
+
+namespace chess {
+
+class Board;
+
+namespace posindex {
+
+// A game that reached a position and the move played from it. Games are
+// identified by the byte offset of their first tag in the source PGN.
+struct Posting {
+    std::uint64_t game;
+    Move move;
+    std::optional<binpos::GameResult> result;
+};
+
+struct MoveStats {
+    Move move;
+    std::uint32_t games;
+    std::uint32_t whiteWins;
+    std::uint32_t draws;
+    std::uint32_t blackWins;
+};
+
+struct BuildOptions {
+    // PGN archive.
+    std::string input;
+    std::string output = "games.idx";
+    int threads = 1;
+    // Plies indexed per game; 0 for whole games.
+    int maxPly = 0;
+    // Memory for sorting postings before they spill to temporary run files
+    // next to the output.
+    int memoryMb = 256;
+};
+
+// Replays every game of the archive and writes the index. Returns false if
+// the archive cannot be read or the index cannot be written.
+bool build(const BuildOptions& options);
+
+// Read-only view of an index file. Postings are sorted by (posKey, game) in
+// varint-compressed blocks with a directory of each block's first key, so a
+// lookup touches the directory and the few blocks holding the key. Move
+// statistics of positions reached by many games are stored precomputed.
+class PositionIndex {
+public:
+    bool open(const char* path) noexcept;
+    void close() noexcept;
+
+    [[nodiscard]] bool isOpen() const noexcept { return file_.isOpen(); }
+    [[nodiscard]] std::uint64_t postingCount() const noexcept;
+
+    [[nodiscard]] std::vector<MoveStats> moveStats(std::uint64_t key) const;
+    [[nodiscard]] std::vector<MoveStats> moveStats(const Board& board) const;
+    // Up to limit games that reached the position, in file order.
+    [[nodiscard]] std::vector<Posting> games(std::uint64_t key, std::size_t limit) const;
+    [[nodiscard]] std::vector<Posting> games(const Board& board, std::size_t limit) const;
+
+private:
+    template <typename Visit>
+    void scan(std::uint64_t key, Visit&& visit) const;
+
+    MappedFile file_;
+};
+
+} // namespace posindex
+
+} // namespace chess
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <iosfwd>
+
+#include "chess/move.hpp"
 #include "chess/types.hpp"
 
 namespace chess {
@@ -9,7 +12,40 @@ class SearchInfo;
 
 namespace search {
 
-void searchPosition(Board& board, SearchInfo& info) noexcept;
+// Limits of one search, as given by UCI "go". Negative times are unset; with
+// no time, depth or node limit the search runs until stopped.
+struct SearchLimits {
+    // 0 for kMaxDepth.
+    int depth = 0;
+    // 0 for no limit.
+    long nodes = 0;
+    int moveTimeMs = -1;
+    // Clock of the side to move.
+    int timeMs = -1;
+    int incrementMs = 0;
+    // 0 for the default horizon.
+    int movesToGo = 0;
+    // Search on the opponent's time; the time limits start at ponderHit.
+    bool ponder = false;
+};
+
+// Sets the depth, node limit, start time and time budget of info from limits.
+void applyLimits(const SearchLimits& limits, SearchInfo& info) noexcept;
+// The opponent played the expected move: the running ponder search goes on
+// as a normal search with the budget applyLimits set aside, counted from now.
+void ponderHit(SearchInfo& info) noexcept;
+// The move the last search expects in reply to best, from the hash table,
+// or no move.
+[[nodiscard]] Move expectedReply(Board& board, Move best) noexcept;
+
+// Iterative deepening up to info.depth() or the time limit; returns the best
+// move of the last completed iteration, a legal move if none completed, or
+// no move if the side to move has none.
+Move searchPosition(Board& board, SearchInfo& info) noexcept;
+
+// Writes info.stats() and info.iterationStats() of the last search as one
+// line of JSON, with the effective branching factor of each iteration.
+void printStatsJson(std::ostream& out, const SearchInfo& info);
 
 } // namespace search
 
@@ -1,10 +1,44 @@
 #pragma once
 
+#include "chess/move.hpp"
 #include "chess/types.hpp"
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <functional>
+#include <iostream>
+#include <span>
+#include <utility>
 
 namespace chess {
 
+// A completed iteration of iterative deepening. pv is valid only for the
+// duration of the callback.
+struct SearchIteration {
+    int depth;
+    int score;
+    long nodes;
+    int timeMs;
+    std::span<const Move> pv;
+};
+
+// Search counters, kept for the whole search and per iteration. Nodes
+// include quiescence nodes; the TT counters are deltas of the table's, so
+// they are approximate on a shared table.
+struct SearchStats {
+    int depth = 0;
+    long nodes = 0;
+    long qnodes = 0;
+    // Beta cutoffs, and those made by the first move searched.
+    long failHigh = 0;
+    long failHighFirst = 0;
+    long ttProbes = 0;
+    long ttHits = 0;
+    long ttCuts = 0;
+    long nullTries = 0;
+    long nullCuts = 0;
+};
+
 class SearchInfo {
 public:
     SearchInfo() noexcept
@@ -14,13 +48,23 @@ public:
           timeSet_(false),
           movesToGo_(0),
           nodes_(0),
+          nodeLimit_(0),
+          bestScore_(0),
           quit_(false),
           stopped_(false),
-          fh_(0.0f),
-          fhf_(0.0f),
-          nullCut_(0),
+          iterationCount_(0),
+          reportStats_(false),
           gameMode_(GameMode::Uci),
-          postThinking_(false) {}
+          postThinking_(false),
+          pollInput_(true),
+          input_(&std::cin),
+          inputFd_(0),
+          output_(&std::cout),
+          stopSignal_(nullptr),
+          ponder_(false),
+          ponderBudget_(-1),
+          ponderHitSignal_(nullptr),
+          useBook_(true) {}
 
     [[nodiscard]] int startTime() const noexcept { return startTime_; }
     [[nodiscard]] int stopTime() const noexcept { return stopTime_; }
@@ -28,13 +72,46 @@ public:
     [[nodiscard]] bool timeSet() const noexcept { return timeSet_; }
     [[nodiscard]] int movesToGo() const noexcept { return movesToGo_; }
     [[nodiscard]] long nodes() const noexcept { return nodes_; }
+    // Search stops once nodes() reaches this; 0 means no limit.
+    [[nodiscard]] long nodeLimit() const noexcept { return nodeLimit_; }
+    // Score of the last completed iteration, from the side to move's view.
+    [[nodiscard]] int bestScore() const noexcept { return bestScore_; }
     [[nodiscard]] bool quit() const noexcept { return quit_; }
     [[nodiscard]] bool stopped() const noexcept { return stopped_; }
-    [[nodiscard]] float fh() const noexcept { return fh_; }
-    [[nodiscard]] float fhf() const noexcept { return fhf_; }
-    [[nodiscard]] int nullCut() const noexcept { return nullCut_; }
+    // Totals of the current or last search.
+    [[nodiscard]] const SearchStats& stats() const noexcept { return stats_; }
+    [[nodiscard]] SearchStats& stats() noexcept { return stats_; }
+    // One entry per completed iteration, depth 1 first.
+    [[nodiscard]] std::span<const SearchStats> iterationStats() const noexcept {
+        return {iterationStats_.data(), static_cast<std::size_t>(iterationCount_)};
+    }
+    // Print the stats as info strings after each iteration and as JSON at
+    // the end of the search, when thinking is posted.
+    [[nodiscard]] bool reportStats() const noexcept { return reportStats_; }
     [[nodiscard]] GameMode gameMode() const noexcept { return gameMode_; }
     [[nodiscard]] bool postThinking() const noexcept { return postThinking_; }
+    // False for searches with no protocol on stdin (benchmarks, batch jobs).
+    [[nodiscard]] bool pollInput() const noexcept { return pollInput_; }
+    // Protocol streams; stdin and stdout unless a server session set them.
+    // inputFd is polled for commands that arrive during a search.
+    [[nodiscard]] std::istream& input() const noexcept { return *input_; }
+    [[nodiscard]] int inputFd() const noexcept { return inputFd_; }
+    [[nodiscard]] std::ostream& output() const noexcept { return *output_; }
+    // Set from another thread to stop the search at its next check.
+    [[nodiscard]] const std::atomic<bool>* stopSignal() const noexcept { return stopSignal_; }
+    // Searching the expected reply on the opponent's time: no time limit
+    // until search::ponderHit starts ponderBudget (ms, -1 for none).
+    [[nodiscard]] bool ponder() const noexcept { return ponder_; }
+    [[nodiscard]] int ponderBudget() const noexcept { return ponderBudget_; }
+    // Set from another thread for search::ponderHit at the next check.
+    [[nodiscard]] const std::atomic<bool>* ponderHitSignal() const noexcept { return ponderHitSignal_; }
+    // Called on the searching thread after each completed iteration.
+    [[nodiscard]] const std::function<void(const SearchIteration&)>& onIteration() const noexcept {
+        return onIteration_;
+    }
+    // Probe the opening book before timed searches. Per session, like the
+    // other options, so one client's setoption does not change another's.
+    [[nodiscard]] bool useBook() const noexcept { return useBook_; }
 
     void setStartTime(int time) noexcept { startTime_ = time; }
     void setStopTime(int time) noexcept { stopTime_ = time; }
@@ -42,13 +119,36 @@ public:
     void setTimeSet(bool set) noexcept { timeSet_ = set; }
     void setMovesToGo(int moves) noexcept { movesToGo_ = moves; }
     void setNodes(long nodes) noexcept { nodes_ = nodes; }
+    void setNodeLimit(long nodes) noexcept { nodeLimit_ = nodes; }
+    void setBestScore(int score) noexcept { bestScore_ = score; }
     void setQuit(bool quit) noexcept { quit_ = quit; }
     void setStopped(bool stopped) noexcept { stopped_ = stopped; }
-    void setFh(float fh) noexcept { fh_ = fh; }
-    void setFhf(float fhf) noexcept { fhf_ = fhf; }
-    void setNullCut(int nullCut) noexcept { nullCut_ = nullCut; }
+    void resetStats() noexcept {
+        stats_ = SearchStats{};
+        iterationCount_ = 0;
+    }
+    void addIterationStats(const SearchStats& stats) noexcept {
+        if (iterationCount_ < kMaxDepth) {
+            iterationStats_[iterationCount_++] = stats;
+        }
+    }
+    void setReportStats(bool report) noexcept { reportStats_ = report; }
     void setGameMode(GameMode mode) noexcept { gameMode_ = mode; }
     void setPostThinking(bool post) noexcept { postThinking_ = post; }
+    void setPollInput(bool poll) noexcept { pollInput_ = poll; }
+    void setInput(std::istream& input, int fd) noexcept {
+        input_ = &input;
+        inputFd_ = fd;
+    }
+    void setOutput(std::ostream& output) noexcept { output_ = &output; }
+    void setStopSignal(const std::atomic<bool>* signal) noexcept { stopSignal_ = signal; }
+    void setPonder(bool ponder) noexcept { ponder_ = ponder; }
+    void setPonderBudget(int ms) noexcept { ponderBudget_ = ms; }
+    void setPonderHitSignal(const std::atomic<bool>* signal) noexcept { ponderHitSignal_ = signal; }
+    void setOnIteration(std::function<void(const SearchIteration&)> callback) {
+        onIteration_ = std::move(callback);
+    }
+    void setUseBook(bool use) noexcept { useBook_ = use; }
 
     void incrementNodes() noexcept { ++nodes_; }
 
@@ -59,27 +159,27 @@ private:
     bool timeSet_;
     int movesToGo_;
     long nodes_;
+    long nodeLimit_;
+    int bestScore_;
     bool quit_;
     bool stopped_;
-    float fh_;
-    float fhf_;
-    int nullCut_;
+    SearchStats stats_;
+    std::array<SearchStats, kMaxDepth> iterationStats_;
+    int iterationCount_;
+    bool reportStats_;
     GameMode gameMode_;
     bool postThinking_;
-};
-
-class EngineOptions {
-public:
-    EngineOptions() noexcept : useBook_(true) {}
-
-    [[nodiscard]] bool useBook() const noexcept { return useBook_; }
-    void setUseBook(bool use) noexcept { useBook_ = use; }
-
-private:
+    bool pollInput_;
+    std::istream* input_;
+    int inputFd_;
+    std::ostream* output_;
+    const std::atomic<bool>* stopSignal_;
+    bool ponder_;
+    int ponderBudget_;
+    const std::atomic<bool>* ponderHitSignal_;
+    std::function<void(const SearchIteration&)> onIteration_;
     bool useBook_;
 };
 
-inline EngineOptions g_engineOptions;
-
 } // namespace chess
 
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+namespace chess::server {
+
+struct Options {
+    // Unix domain socket to listen on; when empty, port is used instead.
+    std::string socketPath;
+    // TCP port on 127.0.0.1.
+    int port = 0;
+    // Concurrent sessions. Each has its own board and thread; further
+    // clients wait until one disconnects.
+    int sessions = 4;
+    int hashMb = 64;
+    // One table of hashMb shared by all sessions, instead of one each.
+    bool sharedHash = true;
+    // Opening book for all sessions; empty keeps the default book.
+    std::string book;
+};
+
+// Accepts UCI clients until the process is terminated. A connection whose
+// first line is "uci" gets a session; others are closed. Returns false if
+// the socket cannot be set up.
+bool run(const Options& options);
+
+} // namespace chess::server
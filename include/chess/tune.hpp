@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+namespace chess::tune {
+
+struct Options {
+    // binpos file of positions with game results, as written by datagen.
+    std::string input;
+    // Receives the tuned weights in the layout of eval_params.hpp.
+    std::string output = "eval_params.hpp";
+    int threads = 1;
+    int epochs = 500;
+    // Adam step size, in centipawns.
+    double learningRate = 1.0;
+    // Target = lambda * result + (1 - lambda) * sigmoid(score); records
+    // without a score always use the result.
+    double lambda = 1.0;
+    // Sigmoid scale per centipawn; 0 fits it to the current weights first.
+    double scale = 0.0;
+    int reportInterval = 50;
+};
+
+// Fits the evaluation weights to the dataset by minimizing the logistic
+// loss of the game outcome, then writes them to options.output. Returns
+// false if the dataset cannot be read or the output cannot be written.
+bool run(const Options& options);
+
+} // namespace chess::tune
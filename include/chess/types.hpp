@@ -10,7 +10,9 @@ namespace chess {
 using Bitboard = std::uint64_t;
 
 inline constexpr int kMaxHash = 1024;
-inline constexpr int kBoardSquareCount = 120;
+inline constexpr int kDefaultEvalCache = 1;
+inline constexpr int kMaxEvalCache = 256;
+inline constexpr int kBoardSquareCount = 64;
 inline constexpr int kMaxGameMoves = 2048;
 inline constexpr int kMaxPositionMoves = 256;
 inline constexpr int kMaxDepth = 64;
@@ -22,7 +24,8 @@ inline constexpr const char* kName = "Chess Forever";
 inline constexpr const char* kVersion = "0.1.0";
 inline constexpr const char* kStartFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 
-enum class Piece : int {
+// Piece, Color and Square are one byte so that Position stays compact.
+enum class Piece : std::uint8_t {
     Empty = 0,
     WhitePawn = 1,
     WhiteKnight = 2,
@@ -38,16 +41,18 @@ enum class Piece : int {
     BlackKing = 12
 };
 
+enum class PieceType : int { None = 0, Pawn = 1, Knight = 2, Bishop = 3, Rook = 4, Queen = 5, King = 6 };
+
 enum class File : int { A = 0, B = 1, C = 2, D = 3, E = 4, F = 5, G = 6, H = 7, None = 8 };
 
 enum class Rank : int { R1 = 0, R2 = 1, R3 = 2, R4 = 3, R5 = 4, R6 = 5, R7 = 6, R8 = 7, None = 8 };
 
-enum class Color : int { White = 0, Black = 1, Both = 2 };
+enum class Color : std::uint8_t { White = 0, Black = 1, Both = 2 };
 
 enum class GameMode : int { Uci = 0, XBoard = 1, Console = 2 };
 
-enum class Square : int {
-    A1 = 21,
+enum class Square : std::uint8_t {
+    A1 = 0,
     B1,
     C1,
     D1,
@@ -55,7 +60,7 @@ enum class Square : int {
     F1,
     G1,
     H1,
-    A2 = 31,
+    A2,
     B2,
     C2,
     D2,
@@ -63,7 +68,7 @@ enum class Square : int {
     F2,
     G2,
     H2,
-    A3 = 41,
+    A3,
     B3,
     C3,
     D3,
@@ -71,7 +76,7 @@ enum class Square : int {
     F3,
     G3,
     H3,
-    A4 = 51,
+    A4,
     B4,
     C4,
     D4,
@@ -79,7 +84,7 @@ enum class Square : int {
     F4,
     G4,
     H4,
-    A5 = 61,
+    A5,
     B5,
     C5,
     D5,
@@ -87,7 +92,7 @@ enum class Square : int {
     F5,
     G5,
     H5,
-    A6 = 71,
+    A6,
     B6,
     C6,
     D6,
@@ -95,7 +100,7 @@ enum class Square : int {
     F6,
     G6,
     H6,
-    A7 = 81,
+    A7,
     B7,
     C7,
     D7,
@@ -103,7 +108,7 @@ enum class Square : int {
     F7,
     G7,
     H7,
-    A8 = 91,
+    A8,
     B8,
     C8,
     D8,
@@ -111,8 +116,7 @@ enum class Square : int {
     F8,
     G8,
     H8,
-    NoSquare = 99,
-    OffBoard = 100
+    NoSquare = 64
 };
 
 enum class CastleRights : std::uint8_t {
@@ -143,30 +147,62 @@ inline constexpr CastleRights& operator&=(CastleRights& a, CastleRights b) {
 
 enum class HashFlag : int { None = 0, Alpha = 1, Beta = 2, Exact = 3 };
 
-inline constexpr int kMoveFlagEnPassant = 0x40000;
-inline constexpr int kMoveFlagPawnStart = 0x80000;
-inline constexpr int kMoveFlagCastle = 0x1000000;
-inline constexpr int kMoveFlagCapture = 0x7C000;
-inline constexpr int kMoveFlagPromotion = 0xF00000;
+// Move layout (16 bits): from (bits 0-5), to (6-11), flag (12-15). The captured
+// piece is not stored; it is read from the board before the move is made.
+enum class MoveFlag : int {
+    Quiet = 0,
+    DoublePush = 1,
+    KingCastle = 2,
+    QueenCastle = 3,
+    Capture = 4,
+    EnPassant = 5,
+    KnightPromotion = 8,
+    BishopPromotion = 9,
+    RookPromotion = 10,
+    QueenPromotion = 11,
+    KnightPromotionCapture = 12,
+    BishopPromotionCapture = 13,
+    RookPromotionCapture = 14,
+    QueenPromotionCapture = 15
+};
+
+inline constexpr int kMoveFlagCapture = 0x4;
+inline constexpr int kMoveFlagPromotion = 0x8;
 
 [[nodiscard]] constexpr int fromSquare(int move) noexcept {
-    return move & 0x7F;
+    return move & 0x3F;
 }
 
 [[nodiscard]] constexpr int toSquare(int move) noexcept {
-    return (move >> 7) & 0x7F;
+    return (move >> 6) & 0x3F;
 }
 
-[[nodiscard]] constexpr int capturedPiece(int move) noexcept {
-    return (move >> 14) & 0xF;
+[[nodiscard]] constexpr int moveFlag(int move) noexcept {
+    return (move >> 12) & 0xF;
 }
 
-[[nodiscard]] constexpr int promotedPiece(int move) noexcept {
-    return (move >> 20) & 0xF;
+[[nodiscard]] constexpr Square squareFromFileRank(File f, Rank r) noexcept {
+    return static_cast<Square>(static_cast<int>(f) + static_cast<int>(r) * 8);
 }
 
-[[nodiscard]] constexpr Square squareFromFileRank(File f, Rank r) noexcept {
-    return static_cast<Square>(21 + static_cast<int>(f) + static_cast<int>(r) * 10);
+[[nodiscard]] constexpr Piece pieceOf(Color color, PieceType type) noexcept {
+    if (type == PieceType::None) {
+        return Piece::Empty;
+    }
+    return static_cast<Piece>(static_cast<int>(type) + (color == Color::Black ? 6 : 0));
+}
+
+[[nodiscard]] constexpr PieceType typeOf(Piece piece) noexcept {
+    const int value = static_cast<int>(piece);
+    return static_cast<PieceType>(value > 6 ? value - 6 : value);
+}
+
+[[nodiscard]] constexpr File fileOf(Square sq) noexcept {
+    return static_cast<File>(static_cast<int>(sq) & 7);
+}
+
+[[nodiscard]] constexpr Rank rankOf(Square sq) noexcept {
+    return static_cast<Rank>(static_cast<int>(sq) >> 3);
 }
 
 // C++20 convenience type aliases
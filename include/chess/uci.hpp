@@ -1,5 +1,7 @@
 #pragma once
 
+#include <iosfwd>
+
 #include "chess/types.hpp"
 
 namespace chess {
@@ -9,7 +11,11 @@ class SearchInfo;
 
 namespace uci {
 
+// Runs the protocol on stdin and stdout.
 void loop(Board& board, SearchInfo& info) noexcept;
+// Runs the protocol on the given streams; inFd is the descriptor behind in,
+// polled for "stop" and "quit" during a search.
+void loop(Board& board, SearchInfo& info, std::istream& in, int inFd, std::ostream& out) noexcept;
 
 } // namespace uci
 
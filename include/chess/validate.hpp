@@ -15,7 +15,6 @@ bool fileRankValid(int fr) noexcept;
 bool pieceValidEmpty(Piece pce) noexcept;
 bool pieceValid(Piece pce) noexcept;
 bool pieceValidEmptyOffbrd(Piece pce) noexcept;
-bool squareIs120(int sq) noexcept;
 bool moveListOk(const MoveList& list, const Board& board) noexcept;
 
 } // namespace validate
@@ -0,0 +1,199 @@
+#include "chess/attacks.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "chess/cpu.hpp"
+#include "chess/types.hpp"
+
+namespace chess::attacks {
+
+std::array<Bitboard, 64> g_knightAttacks{};
+std::array<Bitboard, 64> g_kingAttacks{};
+std::array<std::array<Bitboard, 64>, 2> g_pawnAttacks{};
+std::array<Magic, 64> g_rookMagics{};
+std::array<Magic, 64> g_bishopMagics{};
+std::array<std::array<Bitboard, 64>, 64> g_between{};
+std::array<std::array<Bitboard, 64>, 64> g_line{};
+
+namespace {
+constexpr int kRookTableSize = 0x19000;
+constexpr int kBishopTableSize = 0x1480;
+
+std::array<Bitboard, kRookTableSize> g_rookTable{};
+std::array<Bitboard, kBishopTableSize> g_bishopTable{};
+
+struct Direction {
+    int fileStep;
+    int rankStep;
+};
+
+constexpr std::array<Direction, 4> kRookDirections = {{{0, 1}, {0, -1}, {1, 0}, {-1, 0}}};
+constexpr std::array<Direction, 4> kBishopDirections = {{{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+constexpr std::array<Direction, 8> kKnightSteps = {
+    {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}}};
+constexpr std::array<Direction, 8> kKingSteps = {
+    {{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}}};
+
+constexpr bool onBoard(int file, int rank) noexcept {
+    return file >= 0 && file < 8 && rank >= 0 && rank < 8;
+}
+
+Bitboard stepAttacks(int sq, const Direction* steps, int count) noexcept {
+    Bitboard result = 0ULL;
+    for (int index = 0; index < count; ++index) {
+        const int file = (sq & 7) + steps[index].fileStep;
+        const int rank = (sq >> 3) + steps[index].rankStep;
+        if (onBoard(file, rank)) {
+            result |= 1ULL << (rank * 8 + file);
+        }
+    }
+    return result;
+}
+
+// Reference ray walk used to fill the magic tables.
+Bitboard slidingAttacks(int sq, Bitboard occupied, const std::array<Direction, 4>& directions) noexcept {
+    Bitboard result = 0ULL;
+    for (const auto& dir : directions) {
+        int file = (sq & 7) + dir.fileStep;
+        int rank = (sq >> 3) + dir.rankStep;
+        while (onBoard(file, rank)) {
+            const Bitboard bit = 1ULL << (rank * 8 + file);
+            result |= bit;
+            if ((occupied & bit) != 0) {
+                break;
+            }
+            file += dir.fileStep;
+            rank += dir.rankStep;
+        }
+    }
+    return result;
+}
+
+constexpr Bitboard kRank1 = 0xFFULL;
+constexpr Bitboard kRank8 = kRank1 << 56;
+constexpr Bitboard kFileA = 0x0101010101010101ULL;
+constexpr Bitboard kFileH = kFileA << 7;
+
+class Prng {
+public:
+    explicit Prng(std::uint64_t seed) noexcept : state_(seed) {}
+
+    std::uint64_t next() noexcept {
+        state_ ^= state_ >> 12;
+        state_ ^= state_ << 25;
+        state_ ^= state_ >> 27;
+        return state_ * 2685821657736338717ULL;
+    }
+
+    // Magics work best with few set bits.
+    std::uint64_t sparse() noexcept { return next() & next() & next(); }
+
+private:
+    std::uint64_t state_;
+};
+
+void initMagics(std::array<Magic, 64>& magics, Bitboard* table,
+                const std::array<Direction, 4>& directions) noexcept {
+    // Seeds per rank known to find magics quickly with this generator.
+    constexpr std::array<std::uint64_t, 8> kSeeds = {728, 10316, 55013, 32803,
+                                                     12281, 15100, 16645, 255};
+
+    std::array<Bitboard, 4096> occupancy{};
+    std::array<Bitboard, 4096> reference{};
+    std::array<int, 4096> epoch{};
+    int attempt = 0;
+    Bitboard* next_slice = table;
+
+    for (int sq = 0; sq < 64; ++sq) {
+        const Bitboard edges = ((kRank1 | kRank8) & ~(kRank1 << (8 * (sq >> 3)))) |
+                               ((kFileA | kFileH) & ~(kFileA << (sq & 7)));
+
+        Magic& entry = magics[sq];
+        entry.mask = slidingAttacks(sq, 0ULL, directions) & ~edges;
+        entry.shift = static_cast<unsigned>(64 - std::popcount(entry.mask));
+        entry.attacks = next_slice;
+
+        // Enumerate every subset of the mask with the Carry-Rippler trick.
+        int size = 0;
+        Bitboard subset = 0ULL;
+        do {
+            occupancy[size] = subset;
+            reference[size] = slidingAttacks(sq, subset, directions);
+            ++size;
+            subset = (subset - entry.mask) & entry.mask;
+        } while (subset != 0ULL);
+
+        Bitboard* slice = next_slice;
+        if (cpu::usePext()) {
+            for (int index = 0; index < size; ++index) {
+                slice[cpu::pext(occupancy[index], entry.mask)] = reference[index];
+            }
+            next_slice += size;
+            continue;
+        }
+
+        Prng prng(kSeeds[sq >> 3]);
+        for (int index = 0; index < size;) {
+            do {
+                entry.magic = prng.sparse();
+            } while (std::popcount((entry.magic * entry.mask) >> 56) < 6);
+
+            // epoch[] marks slots written in this attempt so the slice needs no reset.
+            ++attempt;
+            for (index = 0; index < size; ++index) {
+                const unsigned slot = entry.index(occupancy[index]);
+                if (epoch[slot] < attempt) {
+                    epoch[slot] = attempt;
+                    slice[slot] = reference[index];
+                } else if (slice[slot] != reference[index]) {
+                    break;
+                }
+            }
+        }
+
+        next_slice += size;
+    }
+}
+
+void initLeapers() noexcept {
+    for (int sq = 0; sq < 64; ++sq) {
+        g_knightAttacks[sq] = stepAttacks(sq, kKnightSteps.data(), static_cast<int>(kKnightSteps.size()));
+        g_kingAttacks[sq] = stepAttacks(sq, kKingSteps.data(), static_cast<int>(kKingSteps.size()));
+
+        constexpr std::array<Direction, 2> kWhitePawnSteps = {{{-1, 1}, {1, 1}}};
+        constexpr std::array<Direction, 2> kBlackPawnSteps = {{{-1, -1}, {1, -1}}};
+        g_pawnAttacks[static_cast<int>(Color::White)][sq] = stepAttacks(sq, kWhitePawnSteps.data(), 2);
+        g_pawnAttacks[static_cast<int>(Color::Black)][sq] = stepAttacks(sq, kBlackPawnSteps.data(), 2);
+    }
+}
+
+void initLines() noexcept {
+    for (int first = 0; first < 64; ++first) {
+        const Bitboard first_bb = 1ULL << first;
+        for (int second = 0; second < 64; ++second) {
+            const Bitboard second_bb = 1ULL << second;
+            for (const auto* directions : {&kRookDirections, &kBishopDirections}) {
+                if ((slidingAttacks(first, 0ULL, *directions) & second_bb) == 0) {
+                    continue;
+                }
+                g_line[first][second] = (slidingAttacks(first, 0ULL, *directions) &
+                                         slidingAttacks(second, 0ULL, *directions)) |
+                                        first_bb | second_bb;
+                g_between[first][second] = slidingAttacks(first, second_bb, *directions) &
+                                           slidingAttacks(second, first_bb, *directions);
+            }
+        }
+    }
+}
+} // namespace
+
+void init() noexcept {
+    initLeapers();
+    initMagics(g_rookMagics, g_rookTable.data(), kRookDirections);
+    initMagics(g_bishopMagics, g_bishopTable.data(), kBishopDirections);
+    initLines();
+}
+
+} // namespace chess::attacks
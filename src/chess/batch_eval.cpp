@@ -0,0 +1,71 @@
+#include "chess/batch_eval.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <mutex>
+
+#include "chess/evaluate.hpp"
+#include "chess/position.hpp"
+
+namespace chess::eval {
+
+BatchEvaluator::BatchEvaluator(int threads)
+    : threads_(std::max(threads, 1)), start_(threads_), done_(threads_) {
+    workers_.reserve(static_cast<std::size_t>(threads_ - 1));
+    for (int index = 1; index < threads_; ++index) {
+        workers_.emplace_back([this, index] {
+            while (true) {
+                start_.arrive_and_wait();
+                if (quit_) {
+                    return;
+                }
+                scoreRange(index);
+                done_.arrive_and_wait();
+            }
+        });
+    }
+}
+
+BatchEvaluator::~BatchEvaluator() {
+    quit_ = true;
+    start_.arrive_and_wait();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void BatchEvaluator::evaluate(std::span<const Position> positions, std::span<int> out) noexcept {
+    assert(out.size() == positions.size());
+    positions_ = positions;
+    out_ = out;
+    if (workers_.empty()) {
+        scoreRange(0);
+        return;
+    }
+    start_.arrive_and_wait();
+    scoreRange(0);
+    done_.arrive_and_wait();
+}
+
+void BatchEvaluator::scoreRange(int index) const noexcept {
+    // Whole batches per thread, so that only the last one is partly filled.
+    const std::size_t batches = (positions_.size() + kBatchLanes - 1) / kBatchLanes;
+    const auto threads = static_cast<std::size_t>(threads_);
+    const std::size_t first = batches * static_cast<std::size_t>(index) / threads * kBatchLanes;
+    const std::size_t last =
+        std::min(batches * static_cast<std::size_t>(index + 1) / threads * kBatchLanes, positions_.size());
+    for (std::size_t begin = first; begin < last; begin += kBatchLanes) {
+        const std::size_t size = std::min(kBatchLanes, last - begin);
+        evaluateLanes(positions_.subspan(begin, size), out_.subspan(begin, size));
+    }
+}
+
+void evaluateBatch(std::span<const Position> positions, std::span<int> out) {
+    // One evaluator for the process, with a thread per core; callers take turns.
+    static BatchEvaluator evaluator(static_cast<int>(std::max(1U, std::thread::hardware_concurrency())));
+    static std::mutex mutex;
+    const std::scoped_lock lock(mutex);
+    evaluator.evaluate(positions, out);
+}
+
+} // namespace chess::eval
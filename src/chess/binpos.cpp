@@ -0,0 +1,175 @@
+#include "chess/binpos.hpp"
+
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+#include "chess/bitboard.hpp"
+#include "chess/board.hpp"
+#include "chess/internal/data.hpp"
+#include "chess/position.hpp"
+
+namespace chess::binpos {
+
+static_assert(std::endian::native == std::endian::little,
+              "binary position files are written in native byte order");
+
+namespace {
+// Same bound as the piece lists in Position.
+constexpr int kMaxPiecesPerType = 10;
+constexpr int kMaxFiftyMove = 255;
+} // namespace
+
+void PackedPosition::setScore(int score) noexcept {
+    score_ = static_cast<std::int16_t>(score);
+    extras_ |= kHasScore;
+}
+
+void PackedPosition::setResult(GameResult result) noexcept {
+    extras_ = static_cast<std::uint8_t>((extras_ & ~kResultMask) | static_cast<std::uint8_t>(result) |
+                                        kHasResult);
+}
+
+void PackedPosition::setBestMove(Move move) noexcept {
+    move_ = static_cast<std::uint16_t>(move.value());
+    extras_ |= kHasMove;
+}
+
+std::optional<PackedPosition> pack(const Position& pos) noexcept {
+    PackedPosition packed;
+    packed.occupancy_ = pos.occupancy(Color::Both);
+    if (std::popcount(packed.occupancy_) > 32) {
+        return std::nullopt;
+    }
+
+    Bitboard bb = packed.occupancy_;
+    for (int slot = 0; bb != 0ULL; ++slot) {
+        const auto code = static_cast<std::uint8_t>(pos.pieceAt(static_cast<Square>(bitboard::popBit(bb))));
+        packed.pieces_[slot >> 1] |= static_cast<std::uint8_t>(code << ((slot & 1) * 4));
+    }
+
+    packed.state_ = static_cast<std::uint8_t>((pos.side() == Color::Black ? PackedPosition::kSideBit : 0) |
+                                              (pos.castlePerm() << PackedPosition::kCastleShift));
+    packed.enPas_ = static_cast<std::uint8_t>(pos.enPas());
+    packed.fiftyMove_ = static_cast<std::uint8_t>(pos.fiftyMove() < kMaxFiftyMove ? pos.fiftyMove() : kMaxFiftyMove);
+    return packed;
+}
+
+std::optional<PackedPosition> pack(const Board& board) noexcept {
+    return pack(board.position());
+}
+
+bool unpack(const PackedPosition& packed, Position& pos) noexcept {
+    pos.reset();
+
+    Bitboard bb = packed.occupancy_;
+    if (std::popcount(bb) > 32) {
+        return false;
+    }
+    for (int slot = 0; bb != 0ULL; ++slot) {
+        const int sq = bitboard::popBit(bb);
+        const int code = (packed.pieces_[slot >> 1] >> ((slot & 1) * 4)) & 0xF;
+        if (code < static_cast<int>(Piece::WhitePawn) || code > static_cast<int>(Piece::BlackKing)) {
+            return false;
+        }
+        const auto pce = static_cast<Piece>(code);
+        if (pos.pieceCount(pce) >= kMaxPiecesPerType ||
+            (internal::kPiecePawn[code] != 0 && (sq < 8 || sq >= 56))) {
+            return false;
+        }
+        pos.addPiece(static_cast<Square>(sq), pce);
+    }
+    if (pos.pieceCount(Piece::WhiteKing) != 1 || pos.pieceCount(Piece::BlackKing) != 1) {
+        return false;
+    }
+    if (packed.enPas_ > static_cast<std::uint8_t>(Square::NoSquare)) {
+        return false;
+    }
+
+    pos.setSide(packed.side());
+    if (pos.supportedCastlePerm(packed.castlePerm()) != packed.castlePerm() ||
+        !pos.enPassantPossible(packed.enPas())) {
+        return false;
+    }
+    pos.setCastlePerm(packed.castlePerm());
+    pos.setEnPas(packed.enPas());
+    pos.setFiftyMove(packed.fiftyMove_);
+    pos.hashState();
+
+    assert(pos.checkBoard());
+    return true;
+}
+
+bool unpack(const PackedPosition& packed, Board& board) noexcept {
+    Position pos;
+    if (!unpack(packed, pos)) {
+        return false;
+    }
+    board.setPosition(pos);
+    return true;
+}
+
+bool BinaryPositionWriter::open(const char* path, bool append) noexcept {
+    close();
+    file_ = std::fopen(path, append ? "ab" : "wb");
+    if (file_ == nullptr) {
+        return false;
+    }
+    buffer_.reserve(kBufferRecords);
+    count_ = 0;
+    failed_ = false;
+    return true;
+}
+
+bool BinaryPositionWriter::write(const PackedPosition& record) noexcept {
+    if (file_ == nullptr || failed_) {
+        return false;
+    }
+    buffer_.push_back(record);
+    ++count_;
+    return buffer_.size() < kBufferRecords || flush();
+}
+
+bool BinaryPositionWriter::flush() noexcept {
+    if (file_ == nullptr) {
+        return false;
+    }
+    if (!buffer_.empty()) {
+        if (std::fwrite(buffer_.data(), sizeof(PackedPosition), buffer_.size(), file_) != buffer_.size()) {
+            failed_ = true;
+        }
+        buffer_.clear();
+    }
+    return !failed_;
+}
+
+bool BinaryPositionWriter::close() noexcept {
+    if (file_ == nullptr) {
+        return true;
+    }
+    const bool flushed = flush();
+    const bool closed = std::fclose(file_) == 0;
+    file_ = nullptr;
+    return flushed && closed;
+}
+
+bool BinaryPositionReader::open(const char* path) noexcept {
+    index_ = 0;
+    return file_.open(path);
+}
+
+PackedPosition BinaryPositionReader::at(std::size_t index) const noexcept {
+    PackedPosition record;
+    std::memcpy(&record, file_.data().data() + index * sizeof(PackedPosition), sizeof(PackedPosition));
+    return record;
+}
+
+bool BinaryPositionReader::next(PackedPosition& record) noexcept {
+    if (index_ >= size()) {
+        return false;
+    }
+    record = at(index_++);
+    return true;
+}
+
+} // namespace chess::binpos
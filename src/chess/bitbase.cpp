@@ -0,0 +1,33 @@
+#include "chess/bitbase.hpp"
+
+#include "chess/internal/kpk.hpp"
+
+namespace chess::bitbase {
+
+bool kpkWin(Color strong, Square strongKing, Square pawn, Square weakKing, Color sideToMove) noexcept {
+    int white_king = static_cast<int>(strongKing);
+    int black_king = static_cast<int>(weakKing);
+    int pawn_sq = static_cast<int>(pawn);
+
+    // The table has White as the strong side with the pawn on files A-D.
+    if (strong == Color::Black) {
+        white_king ^= 56;
+        black_king ^= 56;
+        pawn_sq ^= 56;
+    }
+    if ((pawn_sq & 7) > 3) {
+        white_king ^= 7;
+        black_king ^= 7;
+        pawn_sq ^= 7;
+    }
+
+    // Not a legal pawn square: fall back to a draw rather than read past the table.
+    if (pawn_sq < 8 || pawn_sq >= 56) {
+        return false;
+    }
+
+    const int index = internal::kpkIndex(sideToMove != strong, white_king, black_king, pawn_sq);
+    return (internal::g_kpkBitbase[static_cast<std::size_t>(index) >> 5] >> (index & 31) & 1U) != 0;
+}
+
+} // namespace chess::bitbase
@@ -1,6 +1,5 @@
 #include "chess/bitboard.hpp"
 
-#include <bit>
 #include <format>
 #include <iostream>
 
@@ -10,22 +9,6 @@
 
 namespace chess::bitboard {
 
-int popBit(Bitboard& bitboard) noexcept {
-    // Use C++20 bit manipulation functions for better performance
-    if (bitboard == 0) {
-        return -1;
-    }
-
-    const int index = std::countr_zero(bitboard);
-    bitboard &= (bitboard - 1); // Clear the lowest set bit
-    return index;
-}
-
-int countBits(Bitboard bitboard) noexcept {
-    // Use C++20 popcount for hardware-accelerated bit counting
-    return std::popcount(bitboard);
-}
-
 void print(Bitboard bitboard) noexcept {
     std::cout << '\n';
 
@@ -35,9 +18,7 @@ void print(Bitboard bitboard) noexcept {
              ++file_idx) {
             const auto square =
                 squareFromFileRank(static_cast<File>(file_idx), static_cast<Rank>(rank_idx));
-            const auto square_64 = internal::g_sq120ToSq64[static_cast<int>(square)];
-
-            const char symbol = ((1ULL << square_64) & bitboard) ? 'X' : '-';
+            const char symbol = ((1ULL << static_cast<int>(square)) & bitboard) ? 'X' : '-';
             std::cout << symbol;
         }
         std::cout << '\n';
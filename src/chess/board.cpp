@@ -1,15 +1,12 @@
 #include "chess/board.hpp"
 
-#include <cassert>
-#include <cctype>
+#include <algorithm>
 #include <format>
 #include <iostream>
-#include <optional>
+#include <string>
 
-#include "chess/bitboard.hpp"
-#include "chess/hash.hpp"
+#include "chess/fen.hpp"
 #include "chess/internal/data.hpp"
-#include "chess/internal/init.hpp"
 #include "chess/types.hpp"
 
 namespace chess {
@@ -19,172 +16,31 @@ Board::Board() noexcept {
 }
 
 void Board::reset() noexcept {
-    for (int index = 0; index < kBoardSquareCount; ++index) {
-        pieces_[index] = Piece::Empty;
-    }
-
-    for (int index = 0; index < 64; ++index) {
-        pieces_[internal::g_sq64ToSq120[index]] = Piece::Empty;
-    }
-
-    for (int index = 0; index < 2; ++index) {
-        bigPce_[index] = 0;
-        majPce_[index] = 0;
-        minPce_[index] = 0;
-        material_[index] = 0;
-    }
-
-    for (int index = 0; index < 3; ++index) {
-        pawns_[index] = 0ULL;
-    }
-
-    for (int index = 0; index < 13; ++index) {
-        pceNum_[index] = 0;
-    }
-
-    kingSq_[0] = kingSq_[1] = Square::NoSquare;
-    side_ = Color::Both;
-    enPas_ = Square::NoSquare;
-    fiftyMove_ = 0;
     ply_ = 0;
     hisPly_ = 0;
-    castlePerm_ = 0;
-    posKey_ = 0ULL;
+    startPly_ = 0;
+    pos().reset();
 }
 
 bool Board::parseFen(std::string_view fen) noexcept {
     reset();
 
-    constexpr auto kBoardSize = 8;
-    constexpr char kRankSeparator = '/';
-    constexpr char kFieldSeparator = ' ';
-
-    // Lambda to convert character to piece
-    const auto charToPiece = [](char ch) constexpr -> std::optional<Piece> {
-        switch (ch) {
-            case 'p':
-                return Piece::BlackPawn;
-            case 'r':
-                return Piece::BlackRook;
-            case 'n':
-                return Piece::BlackKnight;
-            case 'b':
-                return Piece::BlackBishop;
-            case 'k':
-                return Piece::BlackKing;
-            case 'q':
-                return Piece::BlackQueen;
-            case 'P':
-                return Piece::WhitePawn;
-            case 'R':
-                return Piece::WhiteRook;
-            case 'N':
-                return Piece::WhiteKnight;
-            case 'B':
-                return Piece::WhiteBishop;
-            case 'K':
-                return Piece::WhiteKing;
-            case 'Q':
-                return Piece::WhiteQueen;
-            default:
-                return std::nullopt;
-        }
-    };
-
-    auto current_rank = static_cast<int>(Rank::R8);
-    auto current_file = static_cast<int>(File::A);
-    std::size_t pos = 0;
-
-    // Parse board position
-    while (current_rank >= static_cast<int>(Rank::R1) && pos < fen.length()) {
-        const char current_char = fen[pos];
-
-        if (current_char == kRankSeparator || current_char == kFieldSeparator) {
-            current_rank--;
-            current_file = static_cast<int>(File::A);
-            pos++;
-            if (current_char == kFieldSeparator) break;
-            continue;
-        }
-
-        if (std::isdigit(current_char)) {
-            const int empty_squares = current_char - '0';
-            current_file += empty_squares;
-        } else if (const auto piece_opt = charToPiece(current_char)) {
-            const auto square_64 = (current_rank * kBoardSize) + current_file;
-            const auto square_120 = internal::squareTo120(square_64);
-            pieces_[static_cast<int>(square_120)] = *piece_opt;
-            current_file++;
-        } else {
-            return false; // Invalid character
-        }
-
-        pos++;
-    }
-
-    // Parse side to move
-    if (pos >= fen.length() || (fen[pos] != 'w' && fen[pos] != 'b')) {
+    int full_move = 1;
+    if (fen::parse(fen, pos(), &full_move) == 0) {
         return false;
     }
+    startPly_ = 2 * (full_move - 1) + (side() == Color::Black ? 1 : 0);
+    return true;
+}
 
-    side_ = (fen[pos] == 'w') ? Color::White : Color::Black;
-    pos += 2; // Skip side and space
-
-    // Parse castling rights
-    constexpr int kMaxCastleChars = 4;
-    for (int castle_idx = 0; castle_idx < kMaxCastleChars && pos < fen.length(); ++castle_idx) {
-        if (fen[pos] == kFieldSeparator) {
-            break;
-        }
-
-        switch (fen[pos]) {
-            case 'K':
-                castlePerm_ |= static_cast<int>(CastleRights::WhiteKingside);
-                break;
-            case 'Q':
-                castlePerm_ |= static_cast<int>(CastleRights::WhiteQueenside);
-                break;
-            case 'k':
-                castlePerm_ |= static_cast<int>(CastleRights::BlackKingside);
-                break;
-            case 'q':
-                castlePerm_ |= static_cast<int>(CastleRights::BlackQueenside);
-                break;
-            case '-':
-                break; // No castling rights
-            default:
-                break;
-        }
-        pos++;
-    }
-
-    if (pos < fen.length() && fen[pos] == kFieldSeparator) {
-        pos++;
-    }
-
-    // Parse en passant square
-    if (pos < fen.length() && fen[pos] != '-') {
-        if (pos + 1 < fen.length()) {
-            const auto file_char = fen[pos] - 'a';
-            const auto rank_char = fen[pos + 1] - '1';
-            constexpr int kMinFileRank = 0;
-            constexpr int kMaxFileRank = 7;
-
-            if (file_char >= kMinFileRank && file_char <= kMaxFileRank &&
-                rank_char >= kMinFileRank && rank_char <= kMaxFileRank) {
-                enPas_ =
-                    squareFromFileRank(static_cast<File>(file_char), static_cast<Rank>(rank_char));
-            }
-            pos += 2;
-        }
-    } else if (pos < fen.length() && fen[pos] == '-') {
-        pos++;
-    }
-
-    posKey_ = hash::generatePositionKey(*this);
-    updateListsMaterial();
+void Board::setPosition(const Position& position) noexcept {
+    reset();
+    pos() = position;
+    startPly_ = position.side() == Color::Black ? 1 : 0;
+}
 
-    return true;
+std::string Board::toFen() const {
+    return fen::toFen(pos(), (startPly_ + hisPly_) / 2 + 1);
 }
 
 void Board::print() const noexcept {
@@ -198,7 +54,7 @@ void Board::print() const noexcept {
              ++file_idx) {
             const auto square =
                 squareFromFileRank(static_cast<File>(file_idx), static_cast<Rank>(rank_idx));
-            const auto piece = pieces_[static_cast<int>(square)];
+            const auto piece = pieceAt(square);
             std::cout << std::format("{:>3}", internal::kPieceChar[static_cast<int>(piece)]);
         }
         std::cout << '\n';
@@ -210,83 +66,100 @@ void Board::print() const noexcept {
         std::cout << std::format("{:>3}", static_cast<char>('a' + file_idx));
     }
     std::cout << '\n';
-    std::cout << std::format("side:{}\n", internal::kSideChar[static_cast<int>(side_)]);
-    std::cout << std::format("enPas:{}\n", static_cast<int>(enPas_));
+    std::cout << std::format("side:{}\n", internal::kSideChar[static_cast<int>(side())]);
+    std::cout << std::format("enPas:{}\n", static_cast<int>(enPas()));
 
+    const int castle_perm = castlePerm();
     const auto castle_rights = std::format(
         "castle:{}{}{}{}\n",
-        (castlePerm_ & static_cast<int>(CastleRights::WhiteKingside)) != 0 ? 'K' : '-',
-        (castlePerm_ & static_cast<int>(CastleRights::WhiteQueenside)) != 0 ? 'Q' : '-',
-        (castlePerm_ & static_cast<int>(CastleRights::BlackKingside)) != 0 ? 'k' : '-',
-        (castlePerm_ & static_cast<int>(CastleRights::BlackQueenside)) != 0 ? 'q' : '-');
+        (castle_perm & static_cast<int>(CastleRights::WhiteKingside)) != 0 ? 'K' : '-',
+        (castle_perm & static_cast<int>(CastleRights::WhiteQueenside)) != 0 ? 'Q' : '-',
+        (castle_perm & static_cast<int>(CastleRights::BlackKingside)) != 0 ? 'k' : '-',
+        (castle_perm & static_cast<int>(CastleRights::BlackQueenside)) != 0 ? 'q' : '-');
     std::cout << castle_rights;
 
-    std::cout << std::format("PosKey:{:X}\n", posKey_);
+    std::cout << std::format("PosKey:{:X}\n", posKey());
 }
 
-void Board::updateListsMaterial() noexcept {
-    for (int index = 0; index < kBoardSquareCount; ++index) {
-        Square sq = static_cast<Square>(index);
-        Piece piece = pieces_[index];
-        if (piece != Piece::Empty && static_cast<int>(sq) != static_cast<int>(Square::OffBoard)) {
-            Color col = static_cast<Color>(internal::kPieceCol[static_cast<int>(piece)]);
-
-            if (internal::kPieceBig[static_cast<int>(piece)] != 0) {
-                bigPce_[static_cast<int>(col)]++;
-                if (internal::kPieceMaj[static_cast<int>(piece)] != 0) {
-                    majPce_[static_cast<int>(col)]++;
-                } else {
-                    minPce_[static_cast<int>(col)]++;
-                }
-            }
-
-            material_[static_cast<int>(col)] += internal::kPieceVal[static_cast<int>(piece)];
-
-            pList_[static_cast<int>(piece)][pceNum_[static_cast<int>(piece)]] =
-                static_cast<int>(sq);
-            pceNum_[static_cast<int>(piece)]++;
+void Board::mirror() noexcept {}
 
-            if (piece == Piece::WhiteKing) {
-                kingSq_[static_cast<int>(Color::White)] = sq;
-            }
-            if (piece == Piece::BlackKing) {
-                kingSq_[static_cast<int>(Color::Black)] = sq;
-            }
+void Board::dropOldHistory() noexcept {
+    const int dropped = hisPly_ - kMaxGameMoves / 2;
+#if CHESS_COPY_MAKE
+    std::copy(states_.begin() + dropped, states_.begin() + hisPly_ + 1, states_.begin());
+#else
+    std::copy(history_.begin() + dropped, history_.begin() + hisPly_, history_.begin());
+#endif
+    hisPly_ -= dropped;
+    startPly_ += dropped;
+}
 
-            if (piece == Piece::WhitePawn) {
-                int sq64 = internal::g_sq120ToSq64[static_cast<int>(sq)];
-                bitboard::setBit(pawns_[static_cast<int>(Color::White)], sq64);
-                bitboard::setBit(pawns_[static_cast<int>(Color::Both)], sq64);
-            } else if (piece == Piece::BlackPawn) {
-                int sq64 = internal::g_sq120ToSq64[static_cast<int>(sq)];
-                bitboard::setBit(pawns_[static_cast<int>(Color::Black)], sq64);
-                bitboard::setBit(pawns_[static_cast<int>(Color::Both)], sq64);
-            }
-        }
+template <Color Us>
+void Board::makeMove(Move move) noexcept {
+    if (hisPly_ + 1 >= kMaxGameMoves) [[unlikely]] {
+        dropOldHistory();
     }
+#if CHESS_COPY_MAKE
+    states_[hisPly_ + 1] = states_[hisPly_];
+#else
+    pos_.saveUndo(history_[hisPly_], move);
+#endif
+    ++hisPly_;
+    ++ply_;
+    pos().doMove<Us>(move);
 }
 
-bool Board::checkBoard() const noexcept {
-    return true;
+template <Color Us>
+void Board::takeMove() noexcept {
+    --hisPly_;
+    --ply_;
+#if !CHESS_COPY_MAKE
+    pos_.undoMove<Us>(history_[hisPly_]);
+#endif
 }
 
-void Board::mirror() noexcept {}
+template void Board::makeMove<Color::White>(Move move) noexcept;
+template void Board::makeMove<Color::Black>(Move move) noexcept;
+template void Board::takeMove<Color::White>() noexcept;
+template void Board::takeMove<Color::Black>() noexcept;
 
-bool Board::isSquareAttacked(Square sq, Color side) const noexcept {
-    static_cast<void>(sq);
-    static_cast<void>(side);
-    return false;
+void Board::makeMove(Move move) noexcept {
+    if (side() == Color::White) {
+        makeMove<Color::White>(move);
+    } else {
+        makeMove<Color::Black>(move);
+    }
 }
 
-bool Board::makeMove(Move move) noexcept {
-    static_cast<void>(move);
-    return false;
+void Board::takeMove() noexcept {
+    // The side that made the last move is the one not to move now.
+    if (side() == Color::White) {
+        takeMove<Color::Black>();
+    } else {
+        takeMove<Color::White>();
+    }
 }
 
-void Board::takeMove() noexcept {}
-
-void Board::makeNullMove() noexcept {}
+void Board::makeNullMove() noexcept {
+    if (hisPly_ + 1 >= kMaxGameMoves) [[unlikely]] {
+        dropOldHistory();
+    }
+#if CHESS_COPY_MAKE
+    states_[hisPly_ + 1] = states_[hisPly_];
+#else
+    pos_.saveUndo(history_[hisPly_], Move{});
+#endif
+    ++hisPly_;
+    ++ply_;
+    pos().doNullMove();
+}
 
-void Board::takeNullMove() noexcept {}
+void Board::takeNullMove() noexcept {
+    --hisPly_;
+    --ply_;
+#if !CHESS_COPY_MAKE
+    pos_.undoNullMove(history_[hisPly_]);
+#endif
+}
 
 } // namespace chess
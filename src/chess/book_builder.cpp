@@ -0,0 +1,175 @@
+#include "chess/book_builder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "chess/board.hpp"
+#include "chess/mapped_file.hpp"
+#include "chess/misc.hpp"
+#include "chess/pgn.hpp"
+
+namespace chess::polybook {
+
+namespace {
+constexpr int kShardBits = 6;
+constexpr int kShards = 1 << kShardBits;
+// Chunks per thread, so that threads finishing early can take more work.
+constexpr int kChunksPerThread = 8;
+constexpr std::uint32_t kMaxWeight = 0xFFFF;
+
+struct MoveStats {
+    std::uint16_t move;
+    std::uint32_t games;
+    std::uint32_t wins;
+    std::uint32_t draws;
+};
+
+// Positions are spread over shards by the top bits of their key so that
+// threads rarely contend for the same lock.
+struct Shard {
+    std::mutex mutex;
+    std::unordered_map<std::uint64_t, std::vector<MoveStats>> positions;
+};
+
+struct Sample {
+    std::uint64_t key;
+    std::uint16_t move;
+    // 2 for a win by the side to move, 1 for a draw, 0 for a loss.
+    std::uint8_t points;
+};
+
+struct Counters {
+    std::atomic<std::uint64_t> games{0};
+    std::atomic<std::uint64_t> skipped{0};
+    std::atomic<std::uint64_t> errors{0};
+};
+
+void record(std::array<Shard, kShards>& shards, const Sample& sample) {
+    Shard& shard = shards[sample.key >> (64 - kShardBits)];
+    std::lock_guard lock(shard.mutex);
+    auto& moves = shard.positions[sample.key];
+    auto it = std::ranges::find(moves, sample.move, &MoveStats::move);
+    if (it == moves.end()) {
+        moves.push_back({sample.move, 0, 0, 0});
+        it = moves.end() - 1;
+    }
+    ++it->games;
+    it->wins += sample.points == 2 ? 1 : 0;
+    it->draws += sample.points == 1 ? 1 : 0;
+}
+
+void parseChunk(std::string_view text, const BuildOptions& options, Board& board,
+                std::array<Shard, kShards>& shards, Counters& counters) {
+    std::vector<Sample> samples;
+    pgn::PgnReader reader(text);
+    pgn::Game game;
+    while (reader.next(game)) {
+        const auto result = pgn::result(game);
+        if (!result || !pgn::setup(game, board)) {
+            counters.skipped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        samples.clear();
+        pgn::MovetextReader moves(game.movetext);
+        std::string_view san;
+        for (int ply = 0; ply < options.maxPly && moves.next(san); ++ply) {
+            const Move move = pgn::parseSan(board, san);
+            if (move == Move{}) {
+                counters.errors.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            std::uint8_t points = 1;
+            if (*result != binpos::GameResult::Draw) {
+                const bool white_won = *result == binpos::GameResult::WhiteWin;
+                points = white_won == (board.side() == Color::White) ? 2 : 0;
+            }
+            samples.push_back({board.posKey(), encodeMove(move), points});
+            board.makeMove(move);
+        }
+
+        for (const auto& sample : samples) {
+            record(shards, sample);
+        }
+        counters.games.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Flattens the shards into book entries sorted by key, best move first.
+std::vector<Entry> collectEntries(std::array<Shard, kShards>& shards, int minGames) {
+    std::vector<Entry> entries;
+    for (auto& shard : shards) {
+        for (auto& [key, moves] : shard.positions) {
+            std::uint32_t best = 0;
+            for (const auto& stats : moves) {
+                best = std::max(best, 2 * stats.wins + stats.draws);
+            }
+            // Scale per position so that the weights fit in 16 bits.
+            const std::uint64_t divisor = best > kMaxWeight ? (best + kMaxWeight - 1) / kMaxWeight : 1;
+            for (const auto& stats : moves) {
+                const auto weight = static_cast<std::uint16_t>((2 * stats.wins + stats.draws) / divisor);
+                if (stats.games >= static_cast<std::uint32_t>(minGames) && weight > 0) {
+                    entries.push_back({key, stats.move, weight, 0});
+                }
+            }
+        }
+        shard.positions.clear();
+    }
+    std::ranges::sort(entries, [](const Entry& lhs, const Entry& rhs) {
+        return lhs.key != rhs.key ? lhs.key < rhs.key : lhs.weight > rhs.weight;
+    });
+    return entries;
+}
+} // namespace
+
+bool build(const BuildOptions& options) {
+    MappedFile file;
+    if (!file.open(options.input.c_str())) {
+        std::cout << std::format("book: cannot read {}\n", options.input);
+        return false;
+    }
+
+    const int start = misc::getTimeMs();
+    const int threads = options.threads > 0 ? options.threads : 1;
+    const auto chunks = pgn::splitGames(file.data(), threads * kChunksPerThread);
+
+    auto shards = std::make_unique<std::array<Shard, kShards>>();
+    Counters counters;
+    std::atomic<std::size_t> next_chunk{0};
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<std::size_t>(threads));
+    for (int thread = 0; thread < threads; ++thread) {
+        workers.emplace_back([&] {
+            auto board = std::make_unique<Board>();
+            std::size_t chunk;
+            while ((chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) < chunks.size()) {
+                parseChunk(chunks[chunk], options, *board, *shards, counters);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    const auto entries = collectEntries(*shards, options.minGames);
+    if (!writeBook(options.output.c_str(), entries)) {
+        std::cout << std::format("book: cannot write {}\n", options.output);
+        return false;
+    }
+    std::cout << std::format("book: {} games ({} skipped, {} with bad moves), {} entries in {} ms\n",
+                             counters.games.load(), counters.skipped.load(), counters.errors.load(),
+                             entries.size(), misc::getTimeMs() - start)
+              << std::flush;
+    return true;
+}
+
+} // namespace chess::polybook
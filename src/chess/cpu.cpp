@@ -0,0 +1,134 @@
+#include "chess/cpu.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(CHESS_X86_ASM)
+#include <cpuid.h>
+#endif
+
+namespace chess::cpu {
+
+namespace {
+Isa g_isa = Isa::Generic;
+
+using Registers = std::array<std::uint32_t, 4>;
+
+// eax, ebx, ecx, edx of the leaf; zeros if it is not supported.
+Registers cpuid(std::uint32_t leaf, std::uint32_t subleaf) noexcept {
+    Registers regs{};
+#if defined(CHESS_X86_ASM)
+    if (__get_cpuid_max(leaf & 0x80000000U, nullptr) >= leaf) {
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+    }
+#elif defined(CHESS_X86_INTRINSICS)
+    std::array<int, 4> info{};
+    __cpuid(info.data(), static_cast<int>(leaf & 0x80000000U));
+    if (static_cast<std::uint32_t>(info[0]) >= leaf) {
+        __cpuidex(info.data(), static_cast<int>(leaf), static_cast<int>(subleaf));
+        for (std::size_t index = 0; index < regs.size(); ++index) {
+            regs[index] = static_cast<std::uint32_t>(info[index]);
+        }
+    }
+#else
+    static_cast<void>(leaf);
+    static_cast<void>(subleaf);
+#endif
+    return regs;
+}
+
+// Whether the OS saves the YMM registers on context switch.
+bool avxStateEnabled(const Registers& leaf1) noexcept {
+    constexpr std::uint32_t kOsxsave = 1U << 27;
+    if ((leaf1[2] & kOsxsave) == 0) {
+        return false;
+    }
+#if defined(CHESS_X86_ASM)
+    std::uint32_t eax = 0;
+    std::uint32_t edx = 0;
+    asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (eax & 0x6U) == 0x6U;
+#elif defined(CHESS_X86_INTRINSICS)
+    return (_xgetbv(0) & 0x6U) == 0x6U;
+#else
+    return false;
+#endif
+}
+
+bool isAmd() noexcept {
+    const Registers regs = cpuid(0, 0);
+    char vendor[13] = {};
+    std::memcpy(vendor, &regs[1], 4);
+    std::memcpy(vendor + 4, &regs[3], 4);
+    std::memcpy(vendor + 8, &regs[2], 4);
+    return std::strcmp(vendor, "AuthenticAMD") == 0;
+}
+
+int family(const Registers& leaf1) noexcept {
+    const int base = static_cast<int>((leaf1[0] >> 8) & 0xF);
+    return base == 0xF ? base + static_cast<int>((leaf1[0] >> 20) & 0xFF) : base;
+}
+} // namespace
+
+Features detect() noexcept {
+    Features features{};
+    const Registers leaf1 = cpuid(1, 0);
+    const Registers leaf7 = cpuid(7, 0);
+    features.popcnt = (leaf1[2] & (1U << 23)) != 0;
+    features.sse42 = (leaf1[2] & (1U << 20)) != 0;
+    features.avx2 = (leaf7[1] & (1U << 5)) != 0 && avxStateEnabled(leaf1);
+    features.bmi2 = (leaf7[1] & (1U << 8)) != 0;
+    // Zen 1 and 2 (family 17h) run PEXT in microcode, slower than a magic multiply.
+    features.fastPext = features.bmi2 && !(isAmd() && family(leaf1) < 0x19);
+    return features;
+}
+
+void init() noexcept {
+    const Features features = detect();
+    Isa level = Isa::Generic;
+    if (features.popcnt && features.sse42) {
+        level = Isa::Sse42;
+        if (features.avx2 && features.bmi2 && features.fastPext) {
+            level = Isa::Avx2;
+        }
+    }
+
+    if (const char* requested = std::getenv("CHESS_ISA")) {
+        for (const Isa cap : {Isa::Generic, Isa::Sse42, Isa::Avx2}) {
+            if (isaName(cap) == requested && cap < level) {
+                level = cap;
+            }
+        }
+    }
+
+    // A build for a fixed target uses its instructions unconditionally.
+#if defined(__BMI2__)
+    level = Isa::Avx2;
+#elif defined(__POPCNT__)
+    level = std::max(level, Isa::Sse42);
+#endif
+
+    g_isa = level;
+    g_popcnt = level >= Isa::Sse42;
+    g_pext = level >= Isa::Avx2;
+}
+
+Isa isa() noexcept {
+    return g_isa;
+}
+
+std::string_view isaName(Isa isa) noexcept {
+    switch (isa) {
+        case Isa::Sse42:
+            return "sse4.2";
+        case Isa::Avx2:
+            return "avx2";
+        case Isa::Generic:
+            break;
+    }
+    return "generic";
+}
+
+} // namespace chess::cpu
@@ -0,0 +1,221 @@
+#include "chess/datagen.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "chess/binpos.hpp"
+#include "chess/board.hpp"
+#include "chess/evaluate.hpp"
+#include "chess/misc.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/mpsc_queue.hpp"
+#include "chess/search.hpp"
+#include "chess/search_info.hpp"
+
+namespace chess::datagen {
+
+namespace {
+using Batch = std::vector<binpos::PackedPosition>;
+
+constexpr int kProgressInterval = 100;
+
+bool isRepetition(const Board& board) noexcept {
+    const int first = board.hisPly() - board.fiftyMove();
+    for (int index = first > 0 ? first : 0; index < board.hisPly() - 1; ++index) {
+        if (board.historyKey(index) == board.posKey()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isDrawByRule(const Board& board) noexcept {
+    return board.fiftyMove() >= 100 || isRepetition(board) ||
+           (board.pawns(Color::Both) == 0ULL && eval::materialDraw(board.position()));
+}
+
+// Plays random legal moves from the start position; false if the game ended.
+bool playRandomOpening(Board& board, std::mt19937_64& rng, int plies) noexcept {
+    board.parseFen(kStartFen);
+
+    MoveList list;
+    for (int ply = 0; ply <= plies; ++ply) {
+        list.clear();
+        movegen::generateAllMoves(board, list);
+        if (list.empty()) {
+            return false;
+        }
+        if (ply == plies) {
+            break;
+        }
+        std::uniform_int_distribution<int> pick(0, list.size() - 1);
+        board.makeMove(list[pick(rng)]);
+    }
+    return true;
+}
+
+Batch playGame(Board& board, SearchInfo& info, std::mt19937_64& rng, const Options& options) {
+    while (!playRandomOpening(board, rng, options.randomPlies)) {
+    }
+    // Searches keep the table between moves; games start from an empty one.
+    board.hashTable().clear();
+
+    Batch batch;
+    binpos::GameResult result = binpos::GameResult::Draw;
+    int win_plies = 0;
+    int draw_plies = 0;
+
+    for (int ply = 0;; ++ply) {
+        const Color us = board.side();
+        const Color them = us == Color::White ? Color::Black : Color::White;
+        const bool in_check = board.isSquareAttacked(board.kingSquare(us), them);
+
+        MoveList list;
+        movegen::generateAllMoves(board, list);
+        if (list.empty()) {
+            if (in_check) {
+                result = us == Color::White ? binpos::GameResult::BlackWin : binpos::GameResult::WhiteWin;
+            }
+            break;
+        }
+        if (isDrawByRule(board) || ply >= options.maxPly ||
+            board.hisPly() >= kMaxGameMoves - kMaxDepth - 1) {
+            break;
+        }
+
+        info.setDepth(options.depth);
+        info.setNodeLimit(options.nodes);
+        info.setTimeSet(false);
+        info.setStartTime(misc::getTimeMs());
+
+        Move move = search::searchPosition(board, info);
+        const int score = info.bestScore();
+        if (move == Move{}) {
+            // The node limit ran out before the first iteration completed.
+            move = list[0];
+        }
+
+        if (std::abs(score) >= options.winScore) {
+            if (++win_plies >= options.winPlies) {
+                const bool white_ahead = (score > 0) == (us == Color::White);
+                result = white_ahead ? binpos::GameResult::WhiteWin : binpos::GameResult::BlackWin;
+                break;
+            }
+        } else {
+            win_plies = 0;
+        }
+        if (ply >= options.drawMinPly && std::abs(score) <= options.drawScore) {
+            if (++draw_plies >= options.drawPlies) {
+                break;
+            }
+        } else {
+            draw_plies = 0;
+        }
+
+        // Keep quiet positions only: their static eval is what a tuner can learn.
+        if (!in_check && !move.isCapture() && !move.isPromotion() && std::abs(score) < kIsMate) {
+            if (auto packed = binpos::pack(board)) {
+                packed->setScore(score);
+                packed->setBestMove(move);
+                batch.push_back(*packed);
+            }
+        }
+
+        board.makeMove(move);
+    }
+
+    for (auto& packed : batch) {
+        packed.setResult(result);
+    }
+    return batch;
+}
+
+void worker(int id, const Options& options, std::atomic<int>& nextGame, MpscQueue<Batch>& queue,
+            std::atomic<int>& active) {
+    auto board = std::make_unique<Board>();
+    board->hashTable().init(options.hashMb);
+    board->evalCache().init(kDefaultEvalCache);
+
+    SearchInfo info;
+    info.setGameMode(GameMode::Console);
+    info.setPostThinking(false);
+    info.setPollInput(false);
+
+    std::mt19937_64 rng(options.seed + static_cast<std::uint64_t>(id) * 0x9E3779B97F4A7C15ULL);
+    while (nextGame.fetch_add(1, std::memory_order_relaxed) < options.games) {
+        queue.push(playGame(*board, info, rng, options));
+    }
+    active.fetch_sub(1, std::memory_order_release);
+}
+} // namespace
+
+bool run(const Options& options) {
+    binpos::BinaryPositionWriter writer;
+    if (!writer.open(options.output.c_str(), true)) {
+        std::cout << std::format("datagen: cannot open {}\n", options.output);
+        return false;
+    }
+
+    const int threads = options.threads > 0 ? options.threads : 1;
+    std::cout << std::format("datagen: {} games, {} threads, depth {}, nodes {}, output {}\n",
+                             options.games, threads, options.depth, options.nodes, options.output)
+              << std::flush;
+
+    MpscQueue<Batch> queue;
+    std::atomic<int> next_game{0};
+    std::atomic<int> active{threads};
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<std::size_t>(threads));
+    for (int id = 0; id < threads; ++id) {
+        workers.emplace_back(worker, id, std::cref(options), std::ref(next_game), std::ref(queue),
+                             std::ref(active));
+    }
+
+    // This thread is the queue's only consumer and owns the file.
+    const int start = misc::getTimeMs();
+    int games = 0;
+    Batch batch;
+    bool ok = true;
+    while (true) {
+        if (!queue.tryPop(batch)) {
+            if (active.load(std::memory_order_acquire) == 0) {
+                if (!queue.tryPop(batch)) {
+                    break;
+                }
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+        }
+
+        for (const auto& packed : batch) {
+            ok = writer.write(packed) && ok;
+        }
+        if (++games % kProgressInterval == 0) {
+            std::cout << std::format("datagen: {} games, {} positions, {} s\n", games,
+                                     writer.count(), (misc::getTimeMs() - start) / 1000)
+                      << std::flush;
+        }
+    }
+
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    ok = writer.close() && ok;
+
+    const int elapsed = misc::getTimeMs() - start;
+    std::cout << std::format("datagen: done, {} games, {} positions in {} ms{}\n", games,
+                             writer.count(), elapsed, ok ? "" : " (write errors)")
+              << std::flush;
+    return ok;
+}
+
+} // namespace chess::datagen
@@ -0,0 +1,136 @@
+#include "chess/engine.hpp"
+
+#include <chrono>
+#include <utility>
+
+#include "chess/board.hpp"
+#include "chess/internal/init.hpp"
+#include "chess/io.hpp"
+#include "chess/misc.hpp"
+
+namespace chess {
+
+bool SearchHandle::done() const {
+    return result_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+const SearchResult& SearchHandle::wait() const {
+    return result_.get();
+}
+
+Engine::Engine(int hashMb) : board_(std::make_unique<Board>()) {
+    internal::initializeAll();
+    board_->hashTable().init(hashMb);
+    board_->evalCache().init(kDefaultEvalCache);
+    board_->parseFen(kStartFen);
+
+    // No protocol to read or print: stop() and the callback replace both.
+    info_.setPollInput(false);
+    info_.setPostThinking(false);
+    info_.setStopSignal(&stopRequested_);
+    info_.setPonderHitSignal(&ponderHitRequested_);
+}
+
+Engine::~Engine() {
+    stop();
+    wait();
+}
+
+bool Engine::setPosition(std::string_view fen, std::span<const std::string_view> moves) {
+    stop();
+    wait();
+
+    if (!board_->parseFen(fen)) {
+        return false;
+    }
+    for (const auto text : moves) {
+        const auto move = io::parseMove(text, *board_);
+        if (!move) {
+            return false;
+        }
+        board_->makeMove(*move);
+        board_->setPly(0);
+    }
+    return true;
+}
+
+void Engine::newGame() {
+    stop();
+    wait();
+    board_->parseFen(kStartFen);
+    if (!board_->hashTableShared()) {
+        board_->hashTable().clear();
+    }
+}
+
+void Engine::setHashSize(int mb) {
+    stop();
+    wait();
+    board_->hashTable().init(mb);
+}
+
+void Engine::setEvalCacheSize(int mb) {
+    stop();
+    wait();
+    board_->evalCache().init(mb);
+}
+
+bool Engine::saveHash(const char* path) {
+    stop();
+    wait();
+    return board_->hashTable().save(path);
+}
+
+bool Engine::loadHash(const char* path) {
+    stop();
+    wait();
+    return board_->hashTable().load(path);
+}
+
+SearchHandle Engine::startSearch(const search::SearchLimits& limits, ProgressCallback progress) {
+    stop();
+    wait();
+
+    stopRequested_.store(false, std::memory_order_relaxed);
+    ponderHitRequested_.store(false, std::memory_order_relaxed);
+    search::applyLimits(limits, info_);
+    completedDepth_ = 0;
+    info_.setOnIteration([this, progress = std::move(progress)](const SearchIteration& iteration) {
+        completedDepth_ = iteration.depth;
+        if (progress) {
+            progress(iteration);
+        }
+    });
+
+    std::promise<SearchResult> promise;
+    SearchHandle handle(promise.get_future().share());
+    searching_.store(true, std::memory_order_release);
+    worker_ = std::thread([this, promise = std::move(promise)]() mutable {
+        SearchResult result;
+        result.bestMove = search::searchPosition(*board_, info_);
+        result.score = info_.bestScore();
+        result.depth = completedDepth_;
+        result.nodes = info_.nodes();
+        result.timeMs = misc::getTimeMs() - info_.startTime();
+        result.stats = info_.stats();
+        searching_.store(false, std::memory_order_release);
+        promise.set_value(result);
+    });
+    return handle;
+}
+
+void Engine::stop() noexcept {
+    stopRequested_.store(true, std::memory_order_relaxed);
+}
+
+void Engine::ponderHit() noexcept {
+    ponderHitRequested_.store(true, std::memory_order_relaxed);
+}
+
+void Engine::wait() {
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+} // namespace chess
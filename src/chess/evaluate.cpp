@@ -0,0 +1,552 @@
+#include "chess/evaluate.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+
+#include "chess/bitbase.hpp"
+#include "chess/bitboard.hpp"
+#include "chess/board.hpp"
+#include "chess/cpu.hpp"
+#include "chess/eval_params.hpp"
+#include "chess/internal/data.hpp"
+#include "chess/position.hpp"
+#include "chess/types.hpp"
+
+namespace chess::eval {
+
+namespace {
+using namespace params;
+
+// Opponent material at or below a rook, two knights and two pawns counts as
+// an endgame for king placement.
+constexpr int kEndgameMaterial = internal::kPieceVal[static_cast<int>(Piece::WhiteRook)] +
+                                 2 * internal::kPieceVal[static_cast<int>(Piece::WhiteKnight)] +
+                                 2 * internal::kPieceVal[static_cast<int>(Piece::WhitePawn)] +
+                                 internal::kPieceVal[static_cast<int>(Piece::WhiteKing)];
+
+// Every term goes through a sink, so the search's score and the tuner's
+// features come from the same code. ScoreSink inlines to plain table sums.
+struct ScoreSink {
+    int score = 0;
+    void add(int value, int /*feature*/, int coeff) noexcept { score += value * coeff; }
+};
+
+struct FeatureSink {
+    std::vector<Feature>& features;
+    void add(int /*value*/, int feature, int coeff) {
+        features.push_back({static_cast<std::uint16_t>(feature), static_cast<std::int16_t>(coeff)});
+    }
+};
+
+// Added for the winning side of a won KPK ending, which the bitbase knows
+// exactly. Small enough that promoting still scores higher.
+constexpr int kKpkWinBonus = kPieceValue[1];
+
+// Kings and one pawn.
+[[nodiscard]] inline bool isKpk(const Position& pos) noexcept {
+    return pos.pawns(Color::Both) != 0ULL && bitboard::countBits(pos.occupancy(Color::Both)) == 3;
+}
+
+[[nodiscard]] inline int tableIndex(Color color, int sq) noexcept {
+    return color == Color::White ? sq : internal::kMirror64[sq];
+}
+
+[[nodiscard]] constexpr int colorSign(Color color) noexcept {
+    return color == Color::White ? 1 : -1;
+}
+
+// Table values for all pieces of one type and color. Tables are from White's
+// point of view, A1 first; Black looks them up through kMirror64.
+template <typename Sink>
+void tableTerms(const Position& pos, Color color, PieceType type, const std::array<int, 64>& table,
+                TermId term, Sink& sink) {
+    Bitboard bb = pos.pieces(color, type);
+    while (bb != 0ULL) {
+        const int index = tableIndex(color, bitboard::popBit(bb));
+        sink.add(table[index], termOffset(term) + index, colorSign(color));
+    }
+}
+
+template <typename Sink>
+void pawnTerms(const Position& pos, Color color, Sink& sink) {
+    const Bitboard own = pos.pieces(color, PieceType::Pawn);
+    const Bitboard enemy = pos.pieces(color == Color::White ? Color::Black : Color::White,
+                                      PieceType::Pawn);
+    const auto& passed_mask =
+        color == Color::White ? internal::g_whitePassedMask : internal::g_blackPassedMask;
+    const int sign = colorSign(color);
+
+    Bitboard bb = own;
+    while (bb != 0ULL) {
+        const int sq = bitboard::popBit(bb);
+        const int index = tableIndex(color, sq);
+        sink.add(kPawnTable[index], termOffset(TermId::PawnTable) + index, sign);
+        if ((internal::g_isolatedMask[sq] & own) == 0ULL) {
+            sink.add(kPawnIsolated, termOffset(TermId::PawnIsolated), sign);
+        }
+        if ((passed_mask[sq] & enemy) == 0ULL) {
+            const int rank = index >> 3;
+            sink.add(kPawnPassed[rank], termOffset(TermId::PawnPassed) + rank, sign);
+        }
+    }
+}
+
+// Open-file bonus for rooks or queens: no pawns on the file, or only enemy pawns.
+template <typename Sink>
+void fileTerms(const Position& pos, Color color, PieceType type, int open, TermId openTerm,
+               int semiOpen, TermId semiOpenTerm, Sink& sink) {
+    const Bitboard all_pawns = pos.pawns(Color::Both);
+    const Bitboard own_pawns = pos.pieces(color, PieceType::Pawn);
+
+    Bitboard bb = pos.pieces(color, type);
+    while (bb != 0ULL) {
+        const Bitboard file = internal::g_fileBBMask[bitboard::popBit(bb) & 7];
+        if ((all_pawns & file) == 0ULL) {
+            sink.add(open, termOffset(openTerm), colorSign(color));
+        } else if ((own_pawns & file) == 0ULL) {
+            sink.add(semiOpen, termOffset(semiOpenTerm), colorSign(color));
+        }
+    }
+}
+
+template <typename Sink>
+void sideTerms(const Position& pos, Color color, Sink& sink) {
+    const Color them = color == Color::White ? Color::Black : Color::White;
+
+    pawnTerms(pos, color, sink);
+    tableTerms(pos, color, PieceType::Knight, kKnightTable, TermId::KnightTable, sink);
+    tableTerms(pos, color, PieceType::Bishop, kBishopTable, TermId::BishopTable, sink);
+    tableTerms(pos, color, PieceType::Rook, kRookTable, TermId::RookTable, sink);
+    fileTerms(pos, color, PieceType::Rook, kRookOpenFile, TermId::RookOpenFile, kRookSemiOpenFile,
+              TermId::RookSemiOpenFile, sink);
+    fileTerms(pos, color, PieceType::Queen, kQueenOpenFile, TermId::QueenOpenFile, kQueenSemiOpenFile,
+              TermId::QueenSemiOpenFile, sink);
+    if (pos.material(them) <= kEndgameMaterial) {
+        tableTerms(pos, color, PieceType::King, kKingEndgame, TermId::KingEndgame, sink);
+    } else {
+        tableTerms(pos, color, PieceType::King, kKingOpening, TermId::KingOpening, sink);
+    }
+
+    if (pos.pieceCount(pieceOf(color, PieceType::Bishop)) >= 2) {
+        sink.add(kBishopPair, termOffset(TermId::BishopPair), colorSign(color));
+    }
+}
+
+// Evaluation from White's point of view.
+template <typename Sink>
+void evaluateTerms(const Position& pos, Sink& sink) {
+    for (int type = static_cast<int>(PieceType::Pawn); type <= static_cast<int>(PieceType::Queen); ++type) {
+        const auto piece_type = static_cast<PieceType>(type);
+        const int count = pos.pieceCount(pieceOf(Color::White, piece_type)) -
+                          pos.pieceCount(pieceOf(Color::Black, piece_type));
+        if (count != 0) {
+            const int index = type - static_cast<int>(PieceType::Pawn);
+            sink.add(kPieceValue[index], termOffset(TermId::PieceValue) + index, count);
+        }
+    }
+    sideTerms(pos, Color::White, sink);
+    sideTerms(pos, Color::Black, sink);
+}
+
+// evaluateLanes computes the terms of evaluateTerms for a batch at once. Every
+// input is stored as one array over the lanes, so each term is a loop over
+// lanes that the compiler turns into vector code: popcounts of the piece
+// bitboards for material, set-wise masks for the pawn and file terms, and
+// gathers for the tables, one piece of every lane at a time. Unused lanes
+// hold an empty board and are not written out.
+using LaneInts = std::array<std::int32_t, kBatchLanes>;
+using LaneBitboards = std::array<Bitboard, kBatchLanes>;
+
+struct Lanes {
+    std::array<LaneBitboards, 13> pieces{};
+    std::array<LaneInts, 2> material{};
+    std::array<LaneInts, 2> kingSq{};
+    LaneInts sign{};
+    // Filled by scoreLanes.
+    std::array<LaneInts, 13> count{};
+    std::array<LaneBitboards, 2> passed{};
+    LaneInts score{};
+    // Draws by material and KPK, which evaluate() scores instead.
+    LaneInts endgame{};
+};
+
+constexpr Bitboard kLaneFileA = 0x0101010101010101ULL;
+constexpr Bitboard kLaneFileH = kLaneFileA << 7;
+
+[[nodiscard]] constexpr Bitboard northFill(Bitboard bb) noexcept {
+    bb |= bb << 8;
+    bb |= bb << 16;
+    bb |= bb << 32;
+    return bb;
+}
+
+[[nodiscard]] constexpr Bitboard southFill(Bitboard bb) noexcept {
+    bb |= bb >> 8;
+    bb |= bb >> 16;
+    bb |= bb >> 32;
+    return bb;
+}
+
+[[nodiscard]] constexpr Bitboard fileFill(Bitboard bb) noexcept {
+    return southFill(northFill(bb));
+}
+
+[[nodiscard]] constexpr Bitboard adjacentFiles(Bitboard bb) noexcept {
+    return ((bb & ~kLaneFileH) << 1) | ((bb & ~kLaneFileA) >> 1);
+}
+
+// A table indexed by square, Black's mirrored and negated so that every lane
+// just adds its entry. Square 64 reads 0, for lanes with fewer of the piece
+// than the batch's most.
+using LaneTable = std::array<std::int32_t, 65>;
+
+[[nodiscard]] constexpr LaneTable laneTable(const std::array<int, 64>& table, Color color) noexcept {
+    LaneTable result{};
+    for (int sq = 0; sq < 64; ++sq) {
+        result[sq] = color == Color::White ? table[sq] : -table[internal::kMirror64[sq]];
+    }
+    return result;
+}
+
+[[nodiscard]] constexpr LaneTable passedLaneTable(Color color) noexcept {
+    std::array<int, 64> by_square{};
+    for (int sq = 0; sq < 64; ++sq) {
+        by_square[sq] = kPawnPassed[sq >> 3];
+    }
+    return laneTable(by_square, color);
+}
+
+struct PieceTable {
+    Piece piece;
+    LaneTable table;
+};
+
+constexpr std::array<PieceTable, 6> kPieceTables = {{
+    {Piece::WhiteKnight, laneTable(kKnightTable, Color::White)},
+    {Piece::BlackKnight, laneTable(kKnightTable, Color::Black)},
+    {Piece::WhiteBishop, laneTable(kBishopTable, Color::White)},
+    {Piece::BlackBishop, laneTable(kBishopTable, Color::Black)},
+    {Piece::WhiteRook, laneTable(kRookTable, Color::White)},
+    {Piece::BlackRook, laneTable(kRookTable, Color::Black)},
+}};
+
+constexpr std::array<LaneTable, 2> kPawnTables = {laneTable(kPawnTable, Color::White),
+                                                  laneTable(kPawnTable, Color::Black)};
+constexpr std::array<LaneTable, 2> kPassedTables = {passedLaneTable(Color::White),
+                                                    passedLaneTable(Color::Black)};
+
+// Per color, the opening table then the endgame one, indexed by square +
+// 64 in the endgame.
+[[nodiscard]] constexpr std::array<std::int32_t, 128> kingLaneTable(Color color) noexcept {
+    std::array<std::int32_t, 128> result{};
+    const LaneTable opening = laneTable(kKingOpening, color);
+    const LaneTable endgame = laneTable(kKingEndgame, color);
+    for (int sq = 0; sq < 64; ++sq) {
+        result[sq] = opening[sq];
+        result[sq + 64] = endgame[sq];
+    }
+    return result;
+}
+
+constexpr std::array<std::array<std::int32_t, 128>, 2> kKingTables = {kingLaneTable(Color::White),
+                                                                      kingLaneTable(Color::Black)};
+
+// Transposes the positions into lanes.
+void loadLanes(std::span<const Position> positions, Lanes& lanes) noexcept {
+    for (std::size_t lane = 0; lane < positions.size(); ++lane) {
+        const Position& pos = positions[lane];
+        for (int piece = static_cast<int>(Piece::WhitePawn); piece <= static_cast<int>(Piece::BlackKing); ++piece) {
+            lanes.pieces[piece][lane] = pos.pieces(static_cast<Piece>(piece));
+        }
+        for (const Color color : {Color::White, Color::Black}) {
+            lanes.material[static_cast<int>(color)][lane] = pos.material(color);
+            lanes.kingSq[static_cast<int>(color)][lane] = static_cast<std::int32_t>(pos.kingSquare(color));
+        }
+        lanes.sign[lane] = colorSign(pos.side());
+    }
+}
+
+// The builtin compiles to the POPCNT instruction where the function targets
+// it; cpu::popcount tests for it at run time.
+struct TargetPopcount {
+    static int count(Bitboard bb) noexcept { return std::popcount(bb); }
+};
+
+struct DispatchedPopcount {
+    static int count(Bitboard bb) noexcept { return cpu::popcount(bb); }
+};
+
+// Inlined into each instruction-set variant, so that it is compiled for
+// that variant's target.
+#if defined(__GNUC__)
+#define CHESS_LANES_INLINE [[gnu::always_inline]] inline
+#else
+#define CHESS_LANES_INLINE inline
+#endif
+
+// Adds table[square] for every piece of bb in each lane: the lowest piece of
+// all lanes at once, then the next, until the lane with the most runs out.
+// With a passed table, pawns also in passed add that table's entry.
+CHESS_LANES_INLINE void addTable(const LaneBitboards& bb, const LaneInts& count, const LaneTable& table,
+                                 const LaneTable* passedTable, const LaneBitboards* passed,
+                                 LaneInts& score) noexcept {
+    const int most = *std::ranges::max_element(count);
+    LaneBitboards rest = bb;
+    LaneInts squares;
+    for (int nth = 0; nth < most; ++nth) {
+        for (std::size_t lane = 0; lane < kBatchLanes; ++lane) {
+            squares[lane] = rest[lane] != 0 ? std::countr_zero(rest[lane]) : 64;
+        }
+        for (std::size_t lane = 0; lane < kBatchLanes; ++lane) {
+            score[lane] += table[squares[lane]];
+        }
+        if (passedTable != nullptr) {
+            for (std::size_t lane = 0; lane < kBatchLanes; ++lane) {
+                const Bitboard lowest = rest[lane] & (0 - rest[lane]);
+                score[lane] += (lowest & (*passed)[lane]) != 0 ? (*passedTable)[squares[lane]] : 0;
+            }
+        }
+        for (std::size_t lane = 0; lane < kBatchLanes; ++lane) {
+            rest[lane] &= rest[lane] - 1;
+        }
+    }
+}
+
+template <typename Popcount>
+CHESS_LANES_INLINE void scoreLanes(Lanes& lanes) noexcept {
+    auto& score = lanes.score;
+    const auto& pieces = lanes.pieces;
+    auto& count = lanes.count;
+    const auto piece = [](Color color, PieceType type) { return static_cast<int>(pieceOf(color, type)); };
+
+    LaneInts men{};
+    for (int index = static_cast<int>(Piece::WhitePawn); index <= static_cast<int>(Piece::BlackKing); ++index) {
+        for (std::size_t lane = 0; lane < kBatchLanes; ++lane) {
+            count[index][lane] = Popcount::count(pieces[index][lane]);
+            men[lane] += count[index][lane];
+        }
+    }
+
+    // Material and the bishop pair.
+    for (int type = static_cast<int>(PieceType::Pawn); type <= static_cast<int>(PieceType::Queen); ++type) {
+        const auto& white = count[piece(Color::White, static_cast<PieceType>(type))];
+        const auto& black = count[piece(Color::Black, static_cast<PieceType>(type))];
+        const int value = kPieceValue[type - static_cast<int>(PieceType::Pawn)];
+        for (std::size_t lane = 0; lane < kBatchLanes; ++lane) {
+            score[lane] += value * (white[lane] - black[lane]);
+        }
+    }
+    const auto& white_bishops = count[piece(Color::White, PieceType::Bishop)];
+    const auto& black_bishops = count[piece(Color::Black, PieceType::Bishop)];
+    for (std::size_t lane = 0; lane < kBatchLanes; ++lane) {
+        score[lane] += kBishopPair * ((white_bishops[lane] >= 2 ? 1 : 0) - (black_bishops[lane] >= 2 ? 1 : 0));
+    }
+
+    // Pawn structure and open files, set-wise: a pawn is isolated with no own
+    // pawn on an adjacent file, and passed with no enemy pawn ahead of it on
+    // its own or an adjacent file. Passed pawns are scored with the table.
+    const auto& white_pawns = pieces[piece(Color::White, PieceType::Pawn)];
+    const auto& black_pawns = pieces[piece(Color::Black, PieceType::Pawn)];
+    const auto& white_rooks = pieces[piece(Color::White, PieceType::Rook)];
+    const auto& black_rooks = pieces[piece(Color::Black, PieceType::Rook)];
+    const auto& white_queens = pieces[piece(Color::White, PieceType::Queen)];
+    const auto& black_queens = pieces[piece(Color::Black, PieceType::Queen)];
+    for (std::size_t lane = 0; lane < kBatchLanes; ++lane) {
+        const Bitboard white = white_pawns[lane];
+        const Bitboard black = black_pawns[lane];
+        const Bitboard white_files = fileFill(white);
+        const Bitboard black_files = fileFill(black);
+
+        const Bitboard white_isolated = white & ~adjacentFiles(white_files);
+        const Bitboard black_isolated = black & ~adjacentFiles(black_files);
+        score[lane] += kPawnIsolated * (Popcount::count(white_isolated) - Popcount::count(black_isolated));
+
+        const Bitboard below_black = southFill(black >> 8);
+        const Bitboard above_white = northFill(white << 8);
+        lanes.passed[0][lane] = white & ~(below_black | adjacentFiles(below_black));
+        lanes.passed[1][lane] = black & ~(above_white | adjacentFiles(above_white));
+
+        const Bitboard pawn_files = white_files | black_files;
+        const Bitboard open = ~pawn_files;
+        const Bitboard white_semi = pawn_files & ~white_files;
+        const Bitboard black_semi = pawn_files & ~black_files;
+        score[lane] += kRookOpenFile * (Popcount::count(white_rooks[lane] & open) -
+                                        Popcount::count(black_rooks[lane] & open)) +
+                       kRookSemiOpenFile * (Popcount::count(white_rooks[lane] & white_semi) -
+                                            Popcount::count(black_rooks[lane] & black_semi)) +
+                       kQueenOpenFile * (Popcount::count(white_queens[lane] & open) -
+                                         Popcount::count(black_queens[lane] & open)) +
+                       kQueenSemiOpenFile * (Popcount::count(white_queens[lane] & white_semi) -
+                                             Popcount::count(black_queens[lane] & black_semi));
+
+        lanes.endgame[lane] = (white | black) == 0ULL || men[lane] == 3 ? 1 : 0;
+    }
+
+    // Tables.
+    for (const Color color : {Color::White, Color::Black}) {
+        const int side = static_cast<int>(color);
+        const int pawn = piece(color, PieceType::Pawn);
+        addTable(pieces[pawn], count[pawn], kPawnTables[side], &kPassedTables[side], &lanes.passed[side], score);
+    }
+    for (const auto& [table_piece, table] : kPieceTables) {
+        const int index = static_cast<int>(table_piece);
+        addTable(pieces[index], count[index], table, nullptr, nullptr, score);
+    }
+    for (const Color color : {Color::White, Color::Black}) {
+        const auto& table = kKingTables[static_cast<int>(color)];
+        const auto& king_sq = lanes.kingSq[static_cast<int>(color)];
+        const auto& their_material =
+            lanes.material[static_cast<int>(color == Color::White ? Color::Black : Color::White)];
+        for (std::size_t lane = 0; lane < kBatchLanes; ++lane) {
+            score[lane] += table[king_sq[lane] + (their_material[lane] <= kEndgameMaterial ? 64 : 0)];
+        }
+    }
+
+    for (std::size_t lane = 0; lane < kBatchLanes; ++lane) {
+        score[lane] *= lanes.sign[lane];
+    }
+}
+
+#if defined(CHESS_X86_ASM)
+__attribute__((target("avx2,bmi,popcnt"))) void scoreLanesAvx2(Lanes& lanes) noexcept {
+    scoreLanes<TargetPopcount>(lanes);
+}
+#endif
+
+void scoreLanesGeneric(Lanes& lanes) noexcept {
+    scoreLanes<DispatchedPopcount>(lanes);
+}
+} // namespace
+
+bool materialDraw(const Position& pos) noexcept {
+    const int w_n = pos.pieceCount(Piece::WhiteKnight);
+    const int w_b = pos.pieceCount(Piece::WhiteBishop);
+    const int w_r = pos.pieceCount(Piece::WhiteRook);
+    const int w_q = pos.pieceCount(Piece::WhiteQueen);
+    const int b_n = pos.pieceCount(Piece::BlackKnight);
+    const int b_b = pos.pieceCount(Piece::BlackBishop);
+    const int b_r = pos.pieceCount(Piece::BlackRook);
+    const int b_q = pos.pieceCount(Piece::BlackQueen);
+
+    if (w_r == 0 && b_r == 0 && w_q == 0 && b_q == 0) {
+        if (w_b == 0 && b_b == 0) {
+            return w_n < 3 && b_n < 3;
+        }
+        if (w_n == 0 && b_n == 0) {
+            return std::abs(w_b - b_b) < 2;
+        }
+        return ((w_n < 3 && w_b == 0) || (w_b == 1 && w_n == 0)) &&
+               ((b_n < 3 && b_b == 0) || (b_b == 1 && b_n == 0));
+    }
+    if (w_q == 0 && b_q == 0) {
+        if (w_r == 1 && b_r == 1) {
+            return w_n + w_b < 2 && b_n + b_b < 2;
+        }
+        if (w_r == 1 && b_r == 0) {
+            return w_n + w_b == 0 && (b_n + b_b == 1 || b_n + b_b == 2);
+        }
+        if (b_r == 1 && w_r == 0) {
+            return b_n + b_b == 0 && (w_n + w_b == 1 || w_n + w_b == 2);
+        }
+    }
+    return false;
+}
+
+int evaluate(const Position& pos) noexcept {
+    if (pos.pawns(Color::Both) == 0ULL && materialDraw(pos)) {
+        return 0;
+    }
+
+    int bonus = 0;
+    if (isKpk(pos)) {
+        const Color strong = pos.pawns(Color::White) != 0ULL ? Color::White : Color::Black;
+        const Color weak = strong == Color::White ? Color::Black : Color::White;
+        const Square pawn = pos.pieceList(pieceOf(strong, PieceType::Pawn), 0);
+        if (!bitbase::kpkWin(strong, pos.kingSquare(strong), pawn, pos.kingSquare(weak), pos.side())) {
+            return 0;
+        }
+        bonus = colorSign(strong) * kKpkWinBonus;
+    }
+
+    ScoreSink sink;
+    evaluateTerms(pos, sink);
+    const int score = sink.score + bonus;
+    return pos.side() == Color::White ? score : -score;
+}
+
+int evaluate(const Board& board) noexcept {
+    return evaluate(board.position());
+}
+
+void evaluateLanes(std::span<const Position> positions, std::span<int> out) noexcept {
+    assert(positions.size() <= kBatchLanes && out.size() == positions.size());
+    Lanes lanes;
+    loadLanes(positions, lanes);
+#if defined(CHESS_X86_ASM)
+    if (cpu::isa() >= cpu::Isa::Avx2) {
+        scoreLanesAvx2(lanes);
+    } else {
+        scoreLanesGeneric(lanes);
+    }
+#else
+    scoreLanesGeneric(lanes);
+#endif
+
+    for (std::size_t lane = 0; lane < positions.size(); ++lane) {
+        out[lane] = lanes.endgame[lane] != 0 ? evaluate(positions[lane]) : lanes.score[lane];
+    }
+}
+
+std::array<int, kNumParams> weights() noexcept {
+    std::array<int, kNumParams> result{};
+    auto copy = [&result](TermId term, const auto& values) {
+        std::ranges::copy(values, result.begin() + termOffset(term));
+    };
+    copy(TermId::PieceValue, kPieceValue);
+    result[termOffset(TermId::PawnIsolated)] = kPawnIsolated;
+    copy(TermId::PawnPassed, kPawnPassed);
+    result[termOffset(TermId::RookOpenFile)] = kRookOpenFile;
+    result[termOffset(TermId::RookSemiOpenFile)] = kRookSemiOpenFile;
+    result[termOffset(TermId::QueenOpenFile)] = kQueenOpenFile;
+    result[termOffset(TermId::QueenSemiOpenFile)] = kQueenSemiOpenFile;
+    result[termOffset(TermId::BishopPair)] = kBishopPair;
+    copy(TermId::PawnTable, kPawnTable);
+    copy(TermId::KnightTable, kKnightTable);
+    copy(TermId::BishopTable, kBishopTable);
+    copy(TermId::RookTable, kRookTable);
+    copy(TermId::KingOpening, kKingOpening);
+    copy(TermId::KingEndgame, kKingEndgame);
+    return result;
+}
+
+bool extractFeatures(const Position& pos, std::vector<Feature>& features) {
+    features.clear();
+    if ((pos.pawns(Color::Both) == 0ULL && materialDraw(pos)) || isKpk(pos)) {
+        return false;
+    }
+
+    FeatureSink sink{features};
+    evaluateTerms(pos, sink);
+
+    // Merge repeated indices (e.g. a white and a black piece on mirrored
+    // squares) and drop the ones that cancel.
+    std::ranges::sort(features, {}, &Feature::index);
+    std::size_t out = 0;
+    for (std::size_t in = 0; in < features.size(); ++in) {
+        const Feature feature = features[in];
+        if (out > 0 && features[out - 1].index == feature.index) {
+            features[out - 1].coeff = static_cast<std::int16_t>(features[out - 1].coeff + feature.coeff);
+        } else {
+            features[out++] = feature;
+        }
+    }
+    features.resize(out);
+    std::erase_if(features, [](const Feature& feature) { return feature.coeff == 0; });
+    return true;
+}
+
+} // namespace chess::eval
@@ -0,0 +1,331 @@
+#include "chess/fen.hpp"
+
+#include <array>
+#include <cassert>
+#include <charconv>
+
+#include "chess/internal/data.hpp"
+#include "chess/types.hpp"
+
+namespace chess::fen {
+
+namespace {
+// Maximum pieces of one kind the piece lists can hold.
+constexpr int kMaxPiecesPerType = 10;
+
+constexpr std::array<Piece, 256> makeCharToPiece() noexcept {
+    std::array<Piece, 256> table{};
+    for (int index = static_cast<int>(Piece::WhitePawn); index <= static_cast<int>(Piece::BlackKing);
+         ++index) {
+        table[static_cast<unsigned char>(internal::kPieceChar[index])] = static_cast<Piece>(index);
+    }
+    return table;
+}
+
+constexpr auto kCharToPiece = makeCharToPiece();
+
+[[nodiscard]] constexpr bool isDigit(char ch) noexcept {
+    return ch >= '0' && ch <= '9';
+}
+
+// Reads a non-negative integer at text[index], advancing index.
+bool readNumber(std::string_view text, std::size_t& index, int& value) noexcept {
+    const char* first = text.data() + index;
+    const auto [last, ec] = std::from_chars(first, text.data() + text.size(), value);
+    if (ec != std::errc{} || value < 0) {
+        return false;
+    }
+    index += static_cast<std::size_t>(last - first);
+    return true;
+}
+
+[[nodiscard]] std::string_view trim(std::string_view text) noexcept {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Splits "opcode operand; opcode operand; ..." and fills the known opcodes.
+void parseOpcodes(std::string_view text, EpdRecord& record) noexcept {
+    while (true) {
+        text = trim(text);
+        if (text.empty()) {
+            return;
+        }
+
+        std::size_t end = 0;
+        while (end < text.size() && text[end] != ' ' && text[end] != ';') {
+            ++end;
+        }
+        const std::string_view opcode = text.substr(0, end);
+
+        // Operand runs to the next ';' outside quotes.
+        bool quoted = false;
+        std::size_t stop = end;
+        while (stop < text.size() && (quoted || text[stop] != ';')) {
+            if (text[stop] == '"') {
+                quoted = !quoted;
+            }
+            ++stop;
+        }
+        std::string_view operand = trim(text.substr(end, stop - end));
+        if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"') {
+            operand = operand.substr(1, operand.size() - 2);
+        }
+        text.remove_prefix(stop < text.size() ? stop + 1 : stop);
+
+        if (opcode == "bm") {
+            record.bm = operand;
+        } else if (opcode == "am") {
+            record.am = operand;
+        } else if (opcode == "id") {
+            record.id = operand;
+        } else if (opcode == "c0") {
+            record.c0 = operand;
+        } else if (opcode == "hmvc" || opcode == "fmvn") {
+            int value = 0;
+            std::size_t index = 0;
+            if (readNumber(operand, index, value)) {
+                if (opcode == "hmvc") {
+                    record.position.setFiftyMove(value);
+                } else {
+                    record.fullMove = value;
+                }
+            }
+        }
+    }
+}
+
+char* writeNumber(char* out, char* last, int value) noexcept {
+    return std::to_chars(out, last, value).ptr;
+}
+} // namespace
+
+std::size_t parse(std::string_view text, Position& pos, int* fullMove) noexcept {
+    pos.reset();
+
+    const std::size_t size = text.size();
+    std::size_t index = 0;
+    int rank = static_cast<int>(Rank::R8);
+    int file = static_cast<int>(File::A);
+
+    // Piece placement, rank 8 first.
+    while (true) {
+        if (index >= size) {
+            return 0;
+        }
+        const char ch = text[index++];
+        if (ch >= '1' && ch <= '8') {
+            file += ch - '0';
+            if (file > 8) {
+                return 0;
+            }
+        } else if (ch == '/') {
+            if (file != 8 || rank == static_cast<int>(Rank::R1)) {
+                return 0;
+            }
+            --rank;
+            file = static_cast<int>(File::A);
+        } else if (ch == ' ') {
+            if (file != 8 || rank != static_cast<int>(Rank::R1)) {
+                return 0;
+            }
+            break;
+        } else {
+            const Piece pce = kCharToPiece[static_cast<unsigned char>(ch)];
+            if (pce == Piece::Empty || file >= 8 || pos.pieceCount(pce) >= kMaxPiecesPerType) {
+                return 0;
+            }
+            if (internal::kPiecePawn[static_cast<int>(pce)] != 0 &&
+                (rank == static_cast<int>(Rank::R1) || rank == static_cast<int>(Rank::R8))) {
+                return 0;
+            }
+            pos.addPiece(static_cast<Square>(rank * 8 + file), pce);
+            ++file;
+        }
+    }
+    if (pos.pieceCount(Piece::WhiteKing) != 1 || pos.pieceCount(Piece::BlackKing) != 1) {
+        return 0;
+    }
+
+    // Side to move.
+    if (index + 1 >= size || (text[index] != 'w' && text[index] != 'b') || text[index + 1] != ' ') {
+        return 0;
+    }
+    pos.setSide(text[index] == 'w' ? Color::White : Color::Black);
+    index += 2;
+
+    // Castling rights.
+    int castle_perm = 0;
+    if (index < size && text[index] == '-') {
+        ++index;
+    } else {
+        while (index < size && text[index] != ' ') {
+            switch (text[index]) {
+                case 'K':
+                    castle_perm |= static_cast<int>(CastleRights::WhiteKingside);
+                    break;
+                case 'Q':
+                    castle_perm |= static_cast<int>(CastleRights::WhiteQueenside);
+                    break;
+                case 'k':
+                    castle_perm |= static_cast<int>(CastleRights::BlackKingside);
+                    break;
+                case 'q':
+                    castle_perm |= static_cast<int>(CastleRights::BlackQueenside);
+                    break;
+                default:
+                    return 0;
+            }
+            ++index;
+        }
+    }
+    // Rights the placement cannot support are dropped rather than trusted.
+    pos.setCastlePerm(pos.supportedCastlePerm(castle_perm));
+    if (index >= size || text[index] != ' ') {
+        return 0;
+    }
+    ++index;
+
+    // En passant square.
+    if (index < size && text[index] == '-') {
+        ++index;
+    } else if (index + 1 < size && text[index] >= 'a' && text[index] <= 'h' &&
+               (text[index + 1] == '3' || text[index + 1] == '6')) {
+        const Square en_pas = squareFromFileRank(static_cast<File>(text[index] - 'a'),
+                                                 static_cast<Rank>(text[index + 1] - '1'));
+        if (!pos.enPassantPossible(en_pas)) {
+            return 0;
+        }
+        pos.setEnPas(en_pas);
+        index += 2;
+    } else {
+        return 0;
+    }
+
+    // Optional halfmove clock and fullmove number.
+    if (index + 1 < size && text[index] == ' ' && isDigit(text[index + 1])) {
+        ++index;
+        int fifty_move = 0;
+        if (!readNumber(text, index, fifty_move)) {
+            return 0;
+        }
+        pos.setFiftyMove(fifty_move);
+
+        if (index + 1 < size && text[index] == ' ' && isDigit(text[index + 1])) {
+            ++index;
+            int full_move = 1;
+            if (!readNumber(text, index, full_move)) {
+                return 0;
+            }
+            if (fullMove != nullptr) {
+                *fullMove = full_move > 0 ? full_move : 1;
+            }
+        }
+    }
+
+    pos.hashState();
+
+    assert(pos.checkBoard());
+    return index;
+}
+
+std::size_t write(const Position& pos, int fullMove, std::span<char, kMaxFenLength> out) noexcept {
+    char* ptr = out.data();
+    char* const last = out.data() + out.size();
+
+    for (int rank = static_cast<int>(Rank::R8); rank >= static_cast<int>(Rank::R1); --rank) {
+        int empty = 0;
+        for (int file = static_cast<int>(File::A); file <= static_cast<int>(File::H); ++file) {
+            const Piece pce = pos.pieceAt(static_cast<Square>(rank * 8 + file));
+            if (pce == Piece::Empty) {
+                ++empty;
+                continue;
+            }
+            if (empty != 0) {
+                *ptr++ = static_cast<char>('0' + empty);
+                empty = 0;
+            }
+            *ptr++ = internal::kPieceChar[static_cast<int>(pce)];
+        }
+        if (empty != 0) {
+            *ptr++ = static_cast<char>('0' + empty);
+        }
+        *ptr++ = rank > static_cast<int>(Rank::R1) ? '/' : ' ';
+    }
+
+    *ptr++ = internal::kSideChar[static_cast<int>(pos.side())];
+    *ptr++ = ' ';
+
+    const int castle_perm = pos.castlePerm();
+    if (castle_perm == 0) {
+        *ptr++ = '-';
+    } else {
+        if ((castle_perm & static_cast<int>(CastleRights::WhiteKingside)) != 0) *ptr++ = 'K';
+        if ((castle_perm & static_cast<int>(CastleRights::WhiteQueenside)) != 0) *ptr++ = 'Q';
+        if ((castle_perm & static_cast<int>(CastleRights::BlackKingside)) != 0) *ptr++ = 'k';
+        if ((castle_perm & static_cast<int>(CastleRights::BlackQueenside)) != 0) *ptr++ = 'q';
+    }
+    *ptr++ = ' ';
+
+    if (pos.enPas() == Square::NoSquare) {
+        *ptr++ = '-';
+    } else {
+        *ptr++ = internal::kFileChar[static_cast<int>(fileOf(pos.enPas()))];
+        *ptr++ = internal::kRankChar[static_cast<int>(rankOf(pos.enPas()))];
+    }
+    *ptr++ = ' ';
+
+    ptr = writeNumber(ptr, last, pos.fiftyMove());
+    *ptr++ = ' ';
+    ptr = writeNumber(ptr, last, fullMove);
+
+    return static_cast<std::size_t>(ptr - out.data());
+}
+
+std::string toFen(const Position& pos, int fullMove) {
+    std::array<char, kMaxFenLength> buffer;
+    return std::string(buffer.data(), write(pos, fullMove, buffer));
+}
+
+bool EpdReader::next(EpdRecord& record) noexcept {
+    while (offset_ < text_.size()) {
+        std::size_t end = text_.find('\n', offset_);
+        if (end == std::string_view::npos) {
+            end = text_.size();
+        }
+        std::string_view line = text_.substr(offset_, end - offset_);
+        offset_ = end + 1;
+        ++lineNumber_;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        line = trim(line);
+        if (line.empty()) {
+            continue;
+        }
+
+        record.fullMove = 1;
+        const std::size_t consumed = parse(line, record.position, &record.fullMove);
+        if (consumed == 0) {
+            ++errors_;
+            continue;
+        }
+
+        record.line = line;
+        record.bm = {};
+        record.am = {};
+        record.id = {};
+        record.c0 = {};
+        parseOpcodes(line.substr(consumed), record);
+        return true;
+    }
+    return false;
+}
+
+} // namespace chess::fen
@@ -1,63 +1,146 @@
 #include "chess/hash.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <cstring>
 #include <format>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <new>
 #include <ranges>
 #include <span>
 
 #include "chess/board.hpp"
 #include "chess/internal/data.hpp"
+#include "chess/mapped_file.hpp"
 #include "chess/types.hpp"
 
 namespace chess::hash {
 
-std::uint64_t generatePositionKey(const Board& board) noexcept {
+std::uint64_t generatePositionKey(const Position& pos) noexcept {
     std::uint64_t final_key = 0;
 
     // Use ranges to iterate over board squares
     for (const auto square_idx : std::views::iota(0, kBoardSquareCount)) {
-        const auto current_piece = board.pieceAt(static_cast<Square>(square_idx));
-        if (current_piece != Piece::Empty &&
-            static_cast<int>(current_piece) != static_cast<int>(Square::OffBoard)) {
+        const auto current_piece = pos.pieceAt(static_cast<Square>(square_idx));
+        if (current_piece != Piece::Empty) {
             final_key ^= internal::g_pieceKeys[static_cast<int>(current_piece)][square_idx];
         }
     }
 
-    if (board.side() == Color::White) {
+    if (pos.side() == Color::White) {
         final_key ^= internal::g_sideKey;
     }
 
-    if (board.enPas() != Square::NoSquare) {
+    if (pos.enPas() != Square::NoSquare) {
         final_key ^=
-            internal::g_pieceKeys[static_cast<int>(Piece::Empty)][static_cast<int>(board.enPas())];
+            internal::g_pieceKeys[static_cast<int>(Piece::Empty)][static_cast<int>(pos.enPas())];
     }
 
-    final_key ^= internal::g_castleKeys[board.castlePerm()];
+    final_key ^= internal::g_castleKeys[pos.castlePerm()];
 
     return final_key;
 }
 
+std::uint64_t generatePositionKey(const Board& board) noexcept {
+    return generatePositionKey(board.position());
+}
+
 } // namespace chess::hash
 
 namespace chess {
 
+namespace {
+constexpr std::array<char, 8> kFileMagic = {'C', 'H', 'E', 'S', 'S', 'T', 'T', '\0'};
+// Bump when the data word layout or the key to slot mapping changes.
+constexpr std::uint32_t kFileVersion = 1;
+// Slots copied per write, through a stack buffer of 16 KB so that save does
+// not allocate.
+constexpr std::size_t kSaveChunk = 1 << 10;
+
+struct FileHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t slotSize;
+    std::uint64_t entries;
+    std::uint64_t keyChecksum;
+};
+
+static_assert(sizeof(FileHeader) == 32);
+
+// Entries are only meaningful under the Zobrist keys that produced them.
+[[nodiscard]] std::uint64_t keyChecksum() noexcept {
+    std::uint64_t sum = internal::g_sideKey;
+    const auto mix = [&sum](std::uint64_t key) { sum = (sum ^ key) * 0x100000001B3ULL; };
+    for (const auto& keys : internal::g_pieceKeys) {
+        std::ranges::for_each(keys, mix);
+    }
+    std::ranges::for_each(internal::g_castleKeys, mix);
+    return sum;
+}
+
+// Data word layout: move in bits 0-15, score 16-31, depth 32-39, flags 40-47.
+[[nodiscard]] std::uint64_t packEntry(const HashEntry& entry) noexcept {
+    return static_cast<std::uint64_t>(static_cast<std::uint16_t>(entry.move().value())) |
+           static_cast<std::uint64_t>(static_cast<std::uint16_t>(entry.score())) << 16 |
+           static_cast<std::uint64_t>(entry.depth()) << 32 |
+           static_cast<std::uint64_t>(entry.flags()) << 40;
+}
+
+void unpackEntry(std::uint64_t key, std::uint64_t data, HashEntry& entry) noexcept {
+    entry.setPosKey(key);
+    entry.setMove(Move(static_cast<int>(data & 0xFFFF)));
+    entry.setScore(static_cast<std::int16_t>((data >> 16) & 0xFFFF));
+    entry.setDepth(static_cast<int>((data >> 32) & 0xFF));
+    entry.setFlags(static_cast<HashFlag>((data >> 40) & 0xFF));
+}
+} // namespace
+
+bool HashSlot::load(std::uint64_t key, HashEntry& entry) const noexcept {
+    const std::uint64_t data = data_.load(std::memory_order_relaxed);
+    if ((check_.load(std::memory_order_relaxed) ^ data) != key) {
+        return false;
+    }
+    unpackEntry(key, data, entry);
+    return true;
+}
+
+void HashSlot::store(const HashEntry& entry) noexcept {
+    const std::uint64_t data = packEntry(entry);
+    check_.store(entry.posKey() ^ data, std::memory_order_relaxed);
+    data_.store(data, std::memory_order_relaxed);
+}
+
+void HashSlot::clear() noexcept {
+    check_.store(0, std::memory_order_relaxed);
+    data_.store(0, std::memory_order_relaxed);
+}
+
+bool HashSlot::empty() const noexcept {
+    return check_.load(std::memory_order_relaxed) == 0 && data_.load(std::memory_order_relaxed) == 0;
+}
+
 void HashTable::init(int mb) {
-    constexpr int kMegabyte = 0x100000;
+    constexpr std::size_t kMegabyte = 0x100000;
     constexpr int kHashTablePadding = 2;
 
-    const int hash_size = kMegabyte * mb;
-    numEntries_ = hash_size / sizeof(HashEntry);
-    numEntries_ -= kHashTablePadding;
-
-    pTable_ = std::make_unique<HashEntry[]>(numEntries_);
-    if (pTable_) {
-        clear();
-        std::cout << std::format("HashTable init complete with {} entries\n", numEntries_);
-    } else {
+    // Free the old table first, or both would have to fit at once.
+    pTable_.reset();
+    numEntries_ = 0;
+    for (; mb > 0; mb /= 2) {
+        const int entries = static_cast<int>(kMegabyte * static_cast<std::size_t>(mb) / sizeof(HashSlot)) -
+                            kHashTablePadding;
+        pTable_.reset(new (std::nothrow) HashSlot[entries]);
+        if (pTable_) {
+            numEntries_ = entries;
+            clear();
+            std::cout << std::format("HashTable init complete with {} entries\n", numEntries_);
+            return;
+        }
         std::cout << std::format("Hash Allocation Failed, trying {}MB...\n", mb / 2);
-        init(mb / 2);
     }
 }
 
@@ -66,17 +149,166 @@ void HashTable::clear() noexcept {
         return;
     }
 
-    // Use ranges to clear hash table entries
     std::ranges::for_each(std::span{pTable_.get(), static_cast<std::size_t>(numEntries_)},
-                          [](HashEntry& entry) {
-                              entry.setPosKey(0);
-                              entry.setMove(kNoMove);
-                              entry.setDepth(0);
-                              entry.setScore(0);
-                              entry.setFlags(HashFlag::None);
-                          });
-
-    newWrite_ = 0;
+                          [](HashSlot& slot) { slot.clear(); });
+
+    stats_.newWrite.store(0, std::memory_order_relaxed);
+    stats_.overWrite.store(0, std::memory_order_relaxed);
+    stats_.hit.store(0, std::memory_order_relaxed);
+    stats_.cut.store(0, std::memory_order_relaxed);
+}
+
+void HashTable::store(std::uint64_t key, int ply, Move move, int score, HashFlag flags,
+                      int depth) noexcept {
+    HashSlot& target = slot(key);
+
+    if (target.empty()) {
+        incrementNewWrite();
+    } else {
+        incrementOverWrite();
+    }
+
+    if (score > kIsMate) {
+        score += ply;
+    } else if (score < -kIsMate) {
+        score -= ply;
+    }
+
+    HashEntry entry;
+    entry.setPosKey(key);
+    entry.setMove(move);
+    entry.setScore(score);
+    entry.setDepth(depth);
+    entry.setFlags(flags);
+    target.store(entry);
+}
+
+bool HashTable::probe(std::uint64_t key, int ply, Move& move, int& score, int alpha, int beta,
+                      int depth) noexcept {
+    HashEntry entry;
+    if (!slot(key).load(key, entry)) {
+        return false;
+    }
+
+    move = entry.move();
+    if (entry.depth() < depth) {
+        return false;
+    }
+
+    incrementHit();
+    score = entry.score();
+    if (score > kIsMate) {
+        score -= ply;
+    } else if (score < -kIsMate) {
+        score += ply;
+    }
+
+    switch (entry.flags()) {
+        case HashFlag::Alpha:
+            if (score <= alpha) {
+                score = alpha;
+                return true;
+            }
+            break;
+        case HashFlag::Beta:
+            if (score >= beta) {
+                score = beta;
+                return true;
+            }
+            break;
+        case HashFlag::Exact:
+            return true;
+        default:
+            break;
+    }
+    return false;
+}
+
+void EvalCache::init(int mb) {
+    constexpr std::size_t kMegabyte = 0x100000;
+
+    pTable_.reset();
+    mask_ = 0;
+    if (mb <= 0) {
+        return;
+    }
+    const std::size_t entries = std::bit_floor(kMegabyte * static_cast<std::size_t>(mb) / sizeof(std::uint64_t));
+    pTable_ = std::make_unique<std::uint64_t[]>(entries);
+    mask_ = entries - 1;
+}
+
+void EvalCache::clear() noexcept {
+    if (pTable_) {
+        std::fill_n(pTable_.get(), mask_ + 1, std::uint64_t{0});
+    }
+}
+
+bool HashTable::save(const char* path) const noexcept {
+    std::FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    const FileHeader header{kFileMagic, kFileVersion, static_cast<std::uint32_t>(sizeof(HashSlot)),
+                            static_cast<std::uint64_t>(numEntries_), keyChecksum()};
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+    std::array<std::uint64_t, 2 * kSaveChunk> words;
+    for (std::size_t first = 0; ok && first < static_cast<std::size_t>(numEntries_); first += kSaveChunk) {
+        const std::size_t count = std::min(kSaveChunk, static_cast<std::size_t>(numEntries_) - first);
+        for (std::size_t index = 0; index < count; ++index) {
+            const HashSlot& slot = pTable_[first + index];
+            words[2 * index] = slot.check_.load(std::memory_order_relaxed);
+            words[2 * index + 1] = slot.data_.load(std::memory_order_relaxed);
+        }
+        ok = std::fwrite(words.data(), sizeof(std::uint64_t), 2 * count, file) == 2 * count;
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+bool HashTable::load(const char* path) noexcept {
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(FileHeader)) {
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, file.data().data(), sizeof(header));
+    if (header.magic != kFileMagic || header.version != kFileVersion || header.slotSize != sizeof(HashSlot) ||
+        header.keyChecksum != keyChecksum() || header.entries == 0 ||
+        header.entries > static_cast<std::uint64_t>(std::numeric_limits<int>::max()) ||
+        file.size() != sizeof(FileHeader) + header.entries * sizeof(HashSlot)) {
+        return false;
+    }
+
+    // Copied rather than mapped: the table is written by the search, and a
+    // private mapping would fault in every page on first store anyway.
+    std::unique_ptr<HashSlot[]> table(new (std::nothrow) HashSlot[header.entries]);
+    if (!table) {
+        return false;
+    }
+    const char* words = file.data().data() + sizeof(FileHeader);
+    for (std::size_t index = 0; index < header.entries; ++index) {
+        std::uint64_t check = 0;
+        std::uint64_t data = 0;
+        std::memcpy(&check, words + index * sizeof(HashSlot), sizeof(check));
+        std::memcpy(&data, words + index * sizeof(HashSlot) + sizeof(check), sizeof(data));
+        table[index].check_.store(check, std::memory_order_relaxed);
+        table[index].data_.store(data, std::memory_order_relaxed);
+    }
+
+    pTable_ = std::move(table);
+    numEntries_ = static_cast<int>(header.entries);
+    stats_.newWrite.store(0, std::memory_order_relaxed);
+    stats_.overWrite.store(0, std::memory_order_relaxed);
+    stats_.hit.store(0, std::memory_order_relaxed);
+    stats_.cut.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+Move HashTable::probePvMove(std::uint64_t key) const noexcept {
+    HashEntry entry;
+    return slot(key).load(key, entry) ? entry.move() : Move{};
 }
 
 } // namespace chess
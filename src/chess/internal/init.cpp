@@ -1,7 +1,10 @@
 #include "chess/internal/init.hpp"
 
 #include <array>
+#include <mutex>
 
+#include "chess/attacks.hpp"
+#include "chess/cpu.hpp"
 #include "chess/internal/data.hpp"
 #include "chess/movegen.hpp"
 #include "chess/polybook.hpp"
@@ -17,8 +20,10 @@ constexpr std::uint64_t generateRandom64(std::uint64_t seed) noexcept {
     return seed;
 }
 
-constexpr std::array<std::uint64_t, 13 * 120 + 1 + 16> generateHashKeys() noexcept {
-    std::array<std::uint64_t, 13 * 120 + 1 + 16> keys{};
+constexpr std::size_t kHashKeyCount = 13 * kBoardSquareCount + 1 + 16;
+
+constexpr std::array<std::uint64_t, kHashKeyCount> generateHashKeys() noexcept {
+    std::array<std::uint64_t, kHashKeyCount> keys{};
     std::uint64_t seed = 0x123456789ABCDEF0ULL;
     for (std::size_t i = 0; i < keys.size(); ++i) {
         seed = generateRandom64(seed);
@@ -33,7 +38,7 @@ inline constexpr auto kHashKeys = generateHashKeys();
 void initHashKeys() noexcept {
     std::size_t idx = 0;
     for (int index = 0; index < 13; ++index) {
-        for (int index2 = 0; index2 < 120; ++index2) {
+        for (int index2 = 0; index2 < kBoardSquareCount; ++index2) {
             g_pieceKeys[index][index2] = kHashKeys[idx++];
         }
     }
@@ -50,41 +55,6 @@ void initBitMasks() noexcept {
     }
 }
 
-void initSq120To64() noexcept {
-    for (int index = 0; index < kBoardSquareCount; ++index) {
-        g_sq120ToSq64[index] = 65;
-    }
-
-    for (int index = 0; index < 64; ++index) {
-        g_sq64ToSq120[index] = static_cast<int>(Square::OffBoard);
-    }
-
-    int sq64 = 0;
-    for (int rank = static_cast<int>(Rank::R1); rank <= static_cast<int>(Rank::R8); ++rank) {
-        for (int file = static_cast<int>(File::A); file <= static_cast<int>(File::H); ++file) {
-            Square sq = squareFromFileRank(static_cast<File>(file), static_cast<Rank>(rank));
-            g_sq64ToSq120[sq64] = static_cast<int>(sq);
-            g_sq120ToSq64[static_cast<int>(sq)] = sq64;
-            sq64++;
-        }
-    }
-}
-
-void initFilesRanksBrd() noexcept {
-    for (int index = 0; index < kBoardSquareCount; ++index) {
-        g_filesBrd[index] = static_cast<int>(File::None);
-        g_ranksBrd[index] = static_cast<int>(Rank::None);
-    }
-
-    for (int rank = static_cast<int>(Rank::R1); rank <= static_cast<int>(Rank::R8); ++rank) {
-        for (int file = static_cast<int>(File::A); file <= static_cast<int>(File::H); ++file) {
-            Square sq = squareFromFileRank(static_cast<File>(file), static_cast<Rank>(rank));
-            g_filesBrd[static_cast<int>(sq)] = file;
-            g_ranksBrd[static_cast<int>(sq)] = rank;
-        }
-    }
-}
-
 void initEvalMasks() noexcept {
     for (int sq = 0; sq < 8; ++sq) {
         g_fileBBMask[sq] = 0ULL;
@@ -118,9 +88,9 @@ void initEvalMasks() noexcept {
             tsq -= 8;
         }
 
-        Square sq120 = squareTo120(sq);
-        if (g_filesBrd[static_cast<int>(sq120)] > static_cast<int>(File::A)) {
-            g_isolatedMask[sq] |= g_fileBBMask[g_filesBrd[static_cast<int>(sq120)] - 1];
+        const int file = static_cast<int>(fileOf(static_cast<Square>(sq)));
+        if (file > static_cast<int>(File::A)) {
+            g_isolatedMask[sq] |= g_fileBBMask[file - 1];
             tsq = sq + 7;
             while (tsq < 64) {
                 g_whitePassedMask[sq] |= (1ULL << tsq);
@@ -133,8 +103,8 @@ void initEvalMasks() noexcept {
             }
         }
 
-        if (g_filesBrd[static_cast<int>(sq120)] < static_cast<int>(File::H)) {
-            g_isolatedMask[sq] |= g_fileBBMask[g_filesBrd[static_cast<int>(sq120)] + 1];
+        if (file < static_cast<int>(File::H)) {
+            g_isolatedMask[sq] |= g_fileBBMask[file + 1];
             tsq = sq + 9;
             while (tsq < 64) {
                 g_whitePassedMask[sq] |= (1ULL << tsq);
@@ -150,13 +120,17 @@ void initEvalMasks() noexcept {
 }
 
 void initializeAll() noexcept {
-    initSq120To64();
-    initBitMasks();
-    initHashKeys();
-    initFilesRanksBrd();
-    initEvalMasks();
-    movegen::initMvvLva();
-    polybook::init();
+    // Every Engine calls this; tables are filled once per process.
+    static std::once_flag once;
+    std::call_once(once, [] {
+        cpu::init();
+        initBitMasks();
+        initHashKeys();
+        initEvalMasks();
+        attacks::init();
+        movegen::initMvvLva();
+        polybook::init();
+    });
 }
 
 } // namespace chess::internal
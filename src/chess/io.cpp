@@ -0,0 +1,77 @@
+#include "chess/io.hpp"
+
+#include <format>
+#include <iostream>
+
+#include "chess/board.hpp"
+#include "chess/internal/data.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/types.hpp"
+
+namespace chess::io {
+
+namespace {
+[[nodiscard]] constexpr char promotionChar(PieceType type) noexcept {
+    switch (type) {
+        case PieceType::Knight:
+            return 'n';
+        case PieceType::Bishop:
+            return 'b';
+        case PieceType::Rook:
+            return 'r';
+        default:
+            return 'q';
+    }
+}
+} // namespace
+
+std::string printSquare(Square sq) noexcept {
+    return std::format("{}{}", internal::kFileChar[static_cast<int>(fileOf(sq))],
+                       internal::kRankChar[static_cast<int>(rankOf(sq))]);
+}
+
+std::string printMove(Move move) noexcept {
+    if (move == Move{}) {
+        return "0000";
+    }
+    if (move.isPromotion()) {
+        return std::format("{}{}{}", printSquare(move.from()), printSquare(move.to()),
+                           promotionChar(move.promoted()));
+    }
+    return std::format("{}{}", printSquare(move.from()), printSquare(move.to()));
+}
+
+void printMoveList(const MoveList& list) noexcept {
+    std::cout << "MoveList:\n";
+    for (int index = 0; index < list.size(); ++index) {
+        std::cout << std::format("Move:{} > {} (score:{})\n", index + 1, printMove(list[index]),
+                                 list.score(index));
+    }
+    std::cout << std::format("MoveList Total {} Moves:\n\n", list.size());
+}
+
+std::optional<Move> parseMove(std::string_view str, const Board& board) noexcept {
+    if (str.length() < 4 || str[0] < 'a' || str[0] > 'h' || str[1] < '1' || str[1] > '8' ||
+        str[2] < 'a' || str[2] > 'h' || str[3] < '1' || str[3] > '8') {
+        return std::nullopt;
+    }
+
+    const Square from = squareFromFileRank(static_cast<File>(str[0] - 'a'), static_cast<Rank>(str[1] - '1'));
+    const Square to = squareFromFileRank(static_cast<File>(str[2] - 'a'), static_cast<Rank>(str[3] - '1'));
+
+    MoveList list;
+    movegen::generateAllMoves(board, list);
+    for (const Move move : list) {
+        if (move.from() != from || move.to() != to) {
+            continue;
+        }
+        if (move.isPromotion() && (str.length() < 5 || promotionChar(move.promoted()) != str[4])) {
+            continue;
+        }
+        return move;
+    }
+    return std::nullopt;
+}
+
+} // namespace chess::io
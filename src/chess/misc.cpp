@@ -1,12 +1,14 @@
 #include "chess/misc.hpp"
 
+#include <array>
 #include <cctype>
 #include <chrono>
 #include <cstdio>
 #include <iostream>
-#include <string>
+#include <limits>
 #include <string_view>
 
+#include "chess/search.hpp"
 #include "chess/search_info.hpp"
 
 #ifdef _WIN32
@@ -14,9 +16,7 @@
 #include <windows.h>
 
 #else
-#include <sys/select.h>
-#include <sys/time.h>
-#include <unistd.h>
+#include <poll.h>
 #endif
 
 namespace chess::misc {
@@ -29,43 +29,66 @@ int getTimeMs() noexcept {
 }
 
 namespace {
-[[maybe_unused]] constexpr int kMaxSelectTimeout = 16;
 constexpr std::string_view kQuitCommand = "quit";
+constexpr std::string_view kIsReadyCommand = "isready";
+constexpr std::string_view kPonderHitCommand = "ponderhit";
+// Commands read during a search are short; anything longer stops it anyway.
+constexpr std::size_t kMaxInputLine = 256;
 } // namespace
 
-int InputWaiting() noexcept {
+// Input already read into the stream's buffer counts as waiting.
+int InputWaiting(const SearchInfo& info) noexcept {
+    if (info.input().rdbuf()->in_avail() > 0) {
+        return 1;
+    }
 #ifdef _WIN32
     return _kbhit();
 #else
-    fd_set readfds;
-    struct timeval tv;
-    FD_ZERO(&readfds);
-    FD_SET(fileno(stdin), &readfds);
-    tv.tv_sec = 0;
-    tv.tv_usec = 0;
-    const int result = select(kMaxSelectTimeout, &readfds, nullptr, nullptr, &tv);
-    return result > 0 && FD_ISSET(fileno(stdin), &readfds) ? 1 : 0;
+    pollfd descriptor{info.inputFd(), POLLIN, 0};
+    return poll(&descriptor, 1, 0) > 0 && (descriptor.revents & (POLLIN | POLLHUP)) != 0 ? 1 : 0;
 #endif
 }
 
 void readInput(SearchInfo& info) noexcept {
-    if (!InputWaiting()) {
+    if (!InputWaiting(info)) {
         return;
     }
 
-    info.setStopped(true);
-
     try {
-        std::string input;
-        if (std::getline(std::cin, input)) {
-            // Remove trailing whitespace
-            while (!input.empty() && std::isspace(input.back())) {
-                input.pop_back();
-            }
+        std::istream& in = info.input();
+        std::array<char, kMaxInputLine> buffer;
+        in.getline(buffer.data(), buffer.size());
+        if (in.fail() && !in.eof() && in.gcount() == static_cast<std::streamsize>(buffer.size()) - 1) {
+            // The buffer filled up: keep the start, drop the rest of the line.
+            in.clear();
+            in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        } else if (in.fail()) {
+            info.setStopped(true);
+            return;
+        }
+        std::string_view input(buffer.data());
+        // Remove trailing whitespace
+        while (!input.empty() && std::isspace(static_cast<unsigned char>(input.back()))) {
+            input.remove_suffix(1);
+        }
 
-            if (!input.empty() && input.starts_with(kQuitCommand)) {
-                info.setQuit(true);
+        // UCI commands that are answered without ending the search.
+        if (info.gameMode() == GameMode::Uci) {
+            if (input.starts_with(kIsReadyCommand)) {
+                info.output() << "readyok\n" << std::flush;
+                return;
             }
+            if (input.starts_with(kPonderHitCommand)) {
+                if (info.ponder()) {
+                    search::ponderHit(info);
+                }
+                return;
+            }
+        }
+
+        info.setStopped(true);
+        if (input.starts_with(kQuitCommand)) {
+            info.setQuit(true);
         }
     } catch (...) {
         // Ignore input errors in search context
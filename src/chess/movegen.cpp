@@ -1,26 +1,565 @@
 #include "chess/movegen.hpp"
 
+#include <array>
+#include <cstdint>
+
+#include "chess/attacks.hpp"
+#include "chess/bitboard.hpp"
 #include "chess/board.hpp"
 #include "chess/move.hpp"
+#include "chess/types.hpp"
 
 namespace chess::movegen {
 
-void generateAllMoves(const Board& board, MoveList& list) noexcept {
-    static_cast<void>(board);
+namespace {
+constexpr std::array<int, 13> kVictimScore = {0,   100, 200, 300, 400, 500, 600,
+                                              100, 200, 300, 400, 500, 600};
+constexpr int kCaptureBonus = 1000000;
+constexpr int kFirstKillerScore = 900000;
+constexpr int kSecondKillerScore = 800000;
+
+std::array<std::array<int, 13>, 13> g_mvvLvaScores{};
+
+constexpr Bitboard kFileA = 0x0101010101010101ULL;
+constexpr Bitboard kFileH = kFileA << 7;
+constexpr Bitboard kRank3 = 0xFFULL << 16;
+constexpr Bitboard kRank6 = 0xFFULL << 40;
+constexpr Bitboard kRank2 = 0xFFULL << 8;
+constexpr Bitboard kRank7 = 0xFFULL << 48;
+
+// Compile-time constants for the side to move.
+template <Color Us>
+struct SideTraits {
+    static constexpr bool kWhite = Us == Color::White;
+    static constexpr Color kThem = kWhite ? Color::Black : Color::White;
+    static constexpr int kUp = kWhite ? 8 : -8;
+    static constexpr int kUpRight = kWhite ? 9 : -7;
+    static constexpr int kUpLeft = kWhite ? 7 : -9;
+    static constexpr Bitboard kPromotionFrom = kWhite ? kRank7 : kRank2;
+    static constexpr Bitboard kDoublePushRank = kWhite ? kRank3 : kRank6;
+    static constexpr int kKingSide = static_cast<int>(kWhite ? CastleRights::WhiteKingside : CastleRights::BlackKingside);
+    static constexpr int kQueenSide = static_cast<int>(kWhite ? CastleRights::WhiteQueenside : CastleRights::BlackQueenside);
+    static constexpr int kKingFrom = static_cast<int>(kWhite ? Square::E1 : Square::E8);
+};
+
+// Which moves a generator call produces. Captures and Quiets partition All:
+// promotions that capture are captures, the other promotions quiets.
+enum class GenType : std::uint8_t { All, Captures, Quiets };
+
+// Masks computed once per node and shared by every piece generator.
+struct GenContext {
+    Square kingSq;
+    Bitboard occupied;
+    Bitboard ours;
+    Bitboard theirs;
+    Bitboard checkers;
+    Bitboard pinned;
+};
+
+[[nodiscard]] constexpr Bitboard squareBB(int sq) noexcept {
+    return 1ULL << sq;
+}
+
+[[nodiscard]] constexpr bool moreThanOne(Bitboard bb) noexcept {
+    return (bb & (bb - 1)) != 0;
+}
+
+template <int Direction>
+[[nodiscard]] constexpr Bitboard shift(Bitboard bb) noexcept {
+    if constexpr (Direction == 8) {
+        return bb << 8;
+    } else if constexpr (Direction == -8) {
+        return bb >> 8;
+    } else if constexpr (Direction == 9) {
+        return (bb & ~kFileH) << 9;
+    } else if constexpr (Direction == 7) {
+        return (bb & ~kFileA) << 7;
+    } else if constexpr (Direction == -7) {
+        return (bb & ~kFileH) >> 7;
+    } else {
+        return (bb & ~kFileA) >> 9;
+    }
+}
+
+template <Color Us>
+GenContext makeContext(const Board& board) noexcept {
+    constexpr Color kThem = SideTraits<Us>::kThem;
+
+    GenContext ctx{};
+    ctx.kingSq = board.kingSquare(Us);
+    ctx.occupied = board.occupancy(Color::Both);
+    ctx.ours = board.occupancy(Us);
+    ctx.theirs = board.occupancy(kThem);
+    ctx.checkers = board.attackersTo(ctx.kingSq, ctx.occupied) & ctx.theirs;
+
+    // A piece is pinned if it is the only piece between our king and an enemy slider.
+    const Bitboard their_queens = board.pieces(kThem, PieceType::Queen);
+    Bitboard snipers =
+        (attacks::rook(ctx.kingSq, 0ULL) & (board.pieces(kThem, PieceType::Rook) | their_queens)) |
+        (attacks::bishop(ctx.kingSq, 0ULL) & (board.pieces(kThem, PieceType::Bishop) | their_queens));
+    while (snipers != 0) {
+        const int sniper = bitboard::popBit(snipers);
+        const Bitboard blockers = attacks::between(ctx.kingSq, static_cast<Square>(sniper)) & ctx.occupied;
+        if (blockers != 0 && !moreThanOne(blockers) && (blockers & ctx.ours) != 0) {
+            ctx.pinned |= blockers;
+        }
+    }
+    return ctx;
+}
+
+void addCaptureMove(const Board& board, MoveList& list, Move move) noexcept {
+    const Piece victim = board.pieceAt(move.to());
+    const Piece attacker = board.pieceAt(move.from());
+    list.add(move, g_mvvLvaScores[static_cast<int>(victim)][static_cast<int>(attacker)] +
+                       kCaptureBonus);
+}
+
+void addQuietMove(const Board& board, MoveList& list, Move move) noexcept {
+    int score = 0;
+    if (board.searchKiller(0, board.ply()) == move) {
+        score = kFirstKillerScore;
+    } else if (board.searchKiller(1, board.ply()) == move) {
+        score = kSecondKillerScore;
+    } else {
+        score = board.searchHistory(board.pieceAt(move.from()), move.to());
+    }
+    list.add(move, score);
+}
+
+void addPromotions(const Board& board, MoveList& list, int from, int to, bool capture) noexcept {
+    const int capture_bit = capture ? kMoveFlagCapture : 0;
+    constexpr std::array<MoveFlag, 4> kPromotions = {MoveFlag::QueenPromotion, MoveFlag::RookPromotion,
+                                                     MoveFlag::BishopPromotion,
+                                                     MoveFlag::KnightPromotion};
+    for (const auto flag : kPromotions) {
+        const Move move = Move::create(from, to, static_cast<MoveFlag>(static_cast<int>(flag) | capture_bit));
+        if (capture) {
+            addCaptureMove(board, list, move);
+        } else {
+            addQuietMove(board, list, move);
+        }
+    }
+}
+
+// En passant can expose the king along the rank of both pawns, so it is
+// validated by replaying the occupancy change against enemy sliders.
+template <Color Us>
+bool enPassantLegal(const Board& board, const GenContext& ctx, int from, int to) noexcept {
+    constexpr Color kThem = SideTraits<Us>::kThem;
+    const int captured_sq = to - SideTraits<Us>::kUp;
+    const Bitboard occupied = (ctx.occupied ^ squareBB(from) ^ squareBB(captured_sq)) | squareBB(to);
+    const Bitboard their_queens = board.pieces(kThem, PieceType::Queen);
+
+    // Knight and pawn checks are only answered if the checker is the captured pawn.
+    const Bitboard leaper_checkers =
+        ctx.checkers & (board.pieces(kThem, PieceType::Knight) | board.pieces(kThem, PieceType::Pawn));
+    if ((leaper_checkers & ~squareBB(captured_sq)) != 0) {
+        return false;
+    }
+
+    return (attacks::rook(ctx.kingSq, occupied) & (board.pieces(kThem, PieceType::Rook) | their_queens)) == 0 &&
+           (attacks::bishop(ctx.kingSq, occupied) &
+            (board.pieces(kThem, PieceType::Bishop) | their_queens)) == 0;
+}
+
+// Set-wise pawn generation; the caller narrows target for pinned pawns.
+template <Color Us>
+void generatePawnSet(const Board& board, const GenContext& ctx, MoveList& list, Bitboard pawns,
+                     Bitboard target, GenType type) noexcept {
+    using Traits = SideTraits<Us>;
+    const Bitboard empty = ~ctx.occupied;
+    const Bitboard promoting = pawns & Traits::kPromotionFrom;
+    const Bitboard normal = pawns & ~Traits::kPromotionFrom;
+    const Bitboard enemies = ctx.theirs & target;
+
+    Bitboard right = shift<Traits::kUpRight>(normal) & enemies;
+    while (right != 0) {
+        const int to = bitboard::popBit(right);
+        addCaptureMove(board, list, Move::create(to - Traits::kUpRight, to, MoveFlag::Capture));
+    }
+    Bitboard left = shift<Traits::kUpLeft>(normal) & enemies;
+    while (left != 0) {
+        const int to = bitboard::popBit(left);
+        addCaptureMove(board, list, Move::create(to - Traits::kUpLeft, to, MoveFlag::Capture));
+    }
+
+    if (promoting != 0) {
+        Bitboard promo_right = shift<Traits::kUpRight>(promoting) & enemies;
+        while (promo_right != 0) {
+            const int to = bitboard::popBit(promo_right);
+            addPromotions(board, list, to - Traits::kUpRight, to, true);
+        }
+        Bitboard promo_left = shift<Traits::kUpLeft>(promoting) & enemies;
+        while (promo_left != 0) {
+            const int to = bitboard::popBit(promo_left);
+            addPromotions(board, list, to - Traits::kUpLeft, to, true);
+        }
+        if (type != GenType::Captures) {
+            Bitboard promo_push = shift<Traits::kUp>(promoting) & empty & target;
+            while (promo_push != 0) {
+                const int to = bitboard::popBit(promo_push);
+                addPromotions(board, list, to - Traits::kUp, to, false);
+            }
+        }
+    }
+
+    if (type == GenType::Captures) {
+        return;
+    }
+
+    const Bitboard single = shift<Traits::kUp>(normal) & empty;
+    Bitboard double_push = shift<Traits::kUp>(single & Traits::kDoublePushRank) & empty & target;
+    Bitboard push = single & target;
+    while (push != 0) {
+        const int to = bitboard::popBit(push);
+        addQuietMove(board, list, Move::create(to - Traits::kUp, to));
+    }
+    while (double_push != 0) {
+        const int to = bitboard::popBit(double_push);
+        addQuietMove(board, list, Move::create(to - 2 * Traits::kUp, to, MoveFlag::DoublePush));
+    }
+}
+
+template <Color Us>
+void generatePawnMoves(const Board& board, const GenContext& ctx, MoveList& list, Bitboard target,
+                       GenType type) noexcept {
+    const Bitboard pawns = board.pieces(Us, PieceType::Pawn);
+    generatePawnSet<Us>(board, ctx, list, pawns & ~ctx.pinned, target, type);
+
+    // Pinned pawns may only move along the pin line.
+    Bitboard pinned = pawns & ctx.pinned;
+    while (pinned != 0) {
+        const int from = bitboard::popBit(pinned);
+        generatePawnSet<Us>(board, ctx, list, squareBB(from),
+                            target & attacks::line(ctx.kingSq, static_cast<Square>(from)), type);
+    }
+
+    const Square en_pas = board.enPas();
+    if (en_pas != Square::NoSquare && type != GenType::Quiets) {
+        Bitboard capturers = attacks::pawn(SideTraits<Us>::kThem, en_pas) & pawns;
+        while (capturers != 0) {
+            const int from = bitboard::popBit(capturers);
+            if (enPassantLegal<Us>(board, ctx, from, static_cast<int>(en_pas))) {
+                list.add(Move::create(from, static_cast<int>(en_pas), MoveFlag::EnPassant),
+                         kVictimScore[static_cast<int>(Piece::WhitePawn)] + 5 + kCaptureBonus);
+            }
+        }
+    }
+}
+
+void addPieceMoves(const Board& board, const GenContext& ctx, MoveList& list, int from,
+                   Bitboard moves) noexcept {
+    while (moves != 0) {
+        const int to = bitboard::popBit(moves);
+        if ((ctx.theirs & squareBB(to)) != 0) {
+            addCaptureMove(board, list, Move::create(from, to, MoveFlag::Capture));
+        } else {
+            addQuietMove(board, list, Move::create(from, to));
+        }
+    }
+}
+
+template <Color Us>
+void generatePieceMoves(const Board& board, const GenContext& ctx, MoveList& list,
+                        Bitboard target) noexcept {
+    // Pinned knights can never move.
+    Bitboard knights = board.pieces(Us, PieceType::Knight) & ~ctx.pinned;
+    while (knights != 0) {
+        const int from = bitboard::popBit(knights);
+        addPieceMoves(board, ctx, list, from, attacks::knight(static_cast<Square>(from)) & target);
+    }
+
+    const Bitboard queens = board.pieces(Us, PieceType::Queen);
+    Bitboard diagonal = board.pieces(Us, PieceType::Bishop) | queens;
+    while (diagonal != 0) {
+        const int from = bitboard::popBit(diagonal);
+        Bitboard moves = attacks::bishop(static_cast<Square>(from), ctx.occupied) & target;
+        if ((ctx.pinned & squareBB(from)) != 0) {
+            moves &= attacks::line(ctx.kingSq, static_cast<Square>(from));
+        }
+        addPieceMoves(board, ctx, list, from, moves);
+    }
+
+    Bitboard straight = board.pieces(Us, PieceType::Rook) | queens;
+    while (straight != 0) {
+        const int from = bitboard::popBit(straight);
+        Bitboard moves = attacks::rook(static_cast<Square>(from), ctx.occupied) & target;
+        if ((ctx.pinned & squareBB(from)) != 0) {
+            moves &= attacks::line(ctx.kingSq, static_cast<Square>(from));
+        }
+        addPieceMoves(board, ctx, list, from, moves);
+    }
+}
+
+template <Color Us>
+void generateKingMoves(const Board& board, const GenContext& ctx, MoveList& list,
+                       Bitboard target) noexcept {
+    // The king is removed from the occupancy so sliders see through its old square.
+    const Bitboard occupied = ctx.occupied ^ squareBB(static_cast<int>(ctx.kingSq));
+    Bitboard moves = attacks::king(ctx.kingSq) & target;
+    while (moves != 0) {
+        const int to = bitboard::popBit(moves);
+        if (board.isSquareAttacked<SideTraits<Us>::kThem>(static_cast<Square>(to), occupied)) {
+            continue;
+        }
+        if ((ctx.theirs & squareBB(to)) != 0) {
+            addCaptureMove(board, list,
+                           Move::create(static_cast<int>(ctx.kingSq), to, MoveFlag::Capture));
+        } else {
+            addQuietMove(board, list, Move::create(static_cast<int>(ctx.kingSq), to));
+        }
+    }
+}
+
+template <Color Us>
+void generateCastles(const Board& board, const GenContext& ctx, MoveList& list) noexcept {
+    using Traits = SideTraits<Us>;
+    constexpr int kFrom = Traits::kKingFrom;
+    constexpr Color kThem = Traits::kThem;
+    const int perm = board.castlePerm();
+
+    if ((perm & Traits::kKingSide) != 0 &&
+        (ctx.occupied & (squareBB(kFrom + 1) | squareBB(kFrom + 2))) == 0 &&
+        !board.isSquareAttacked<kThem>(static_cast<Square>(kFrom + 1), ctx.occupied) &&
+        !board.isSquareAttacked<kThem>(static_cast<Square>(kFrom + 2), ctx.occupied)) {
+        addQuietMove(board, list, Move::create(kFrom, kFrom + 2, MoveFlag::KingCastle));
+    }
+
+    if ((perm & Traits::kQueenSide) != 0 &&
+        (ctx.occupied & (squareBB(kFrom - 1) | squareBB(kFrom - 2) | squareBB(kFrom - 3))) == 0 &&
+        !board.isSquareAttacked<kThem>(static_cast<Square>(kFrom - 1), ctx.occupied) &&
+        !board.isSquareAttacked<kThem>(static_cast<Square>(kFrom - 2), ctx.occupied)) {
+        addQuietMove(board, list, Move::create(kFrom, kFrom - 2, MoveFlag::QueenCastle));
+    }
+}
+
+// Destination squares of the moves type asks for. Pawns narrow it further:
+// their captures need an enemy on the square, their pushes an empty one.
+[[nodiscard]] constexpr Bitboard targetFor(const GenContext& ctx, GenType type) noexcept {
+    switch (type) {
+        case GenType::Captures:
+            return ctx.theirs;
+        case GenType::Quiets:
+            return ~ctx.occupied;
+        default:
+            return ~ctx.ours;
+    }
+}
+
+// In check: king moves, and with a single checker also captures of the checker
+// and interpositions on the checking line.
+template <Color Us>
+void generateEvasions(const Board& board, const GenContext& ctx, MoveList& list,
+                      GenType type) noexcept {
+    const Bitboard destinations = targetFor(ctx, type);
+    generateKingMoves<Us>(board, ctx, list, destinations);
+    if (moreThanOne(ctx.checkers)) {
+        return;
+    }
+
+    Bitboard checkers = ctx.checkers;
+    const auto checker = static_cast<Square>(bitboard::popBit(checkers));
+    const Bitboard target = (attacks::between(ctx.kingSq, checker) | ctx.checkers) & destinations;
+    generatePawnMoves<Us>(board, ctx, list, target, type);
+    generatePieceMoves<Us>(board, ctx, list, target);
+}
+
+template <Color Us>
+void generateNonEvasions(const Board& board, const GenContext& ctx, MoveList& list,
+                         GenType type) noexcept {
+    const Bitboard target = targetFor(ctx, type);
+    generatePawnMoves<Us>(board, ctx, list, target, type);
+    generatePieceMoves<Us>(board, ctx, list, target);
+    generateKingMoves<Us>(board, ctx, list, target);
+    if (type != GenType::Captures) {
+        generateCastles<Us>(board, ctx, list);
+    }
+}
+
+// The checks the generators make while producing move, applied to move
+// alone. Castling is checked in full apart from the king being in check.
+template <Color Us>
+bool pseudoLegal(const Board& board, Move move) noexcept {
+    using Traits = SideTraits<Us>;
+    const int from = static_cast<int>(move.from());
+    const int to = static_cast<int>(move.to());
+    const MoveFlag flag = move.flag();
+    const Bitboard occupied = board.occupancy(Color::Both);
+    const Bitboard theirs = board.occupancy(Traits::kThem);
+    const Bitboard to_bb = squareBB(to);
+
+    if (from == to || (board.occupancy(Us) & squareBB(from)) == 0 || (board.occupancy(Us) & to_bb) != 0) {
+        return false;
+    }
+
+    const PieceType type = typeOf(board.pieceAt(move.from()));
+    if (type == PieceType::Pawn) {
+        if (move.isPromotion() != ((squareBB(from) & Traits::kPromotionFrom) != 0)) {
+            return false;
+        }
+        if (flag == MoveFlag::EnPassant) {
+            return move.to() == board.enPas() && (attacks::pawn(Us, move.from()) & to_bb) != 0;
+        }
+        if (move.isCapture()) {
+            return (flag == MoveFlag::Capture || move.isPromotion()) &&
+                   (attacks::pawn(Us, move.from()) & theirs & to_bb) != 0;
+        }
+        if (flag == MoveFlag::DoublePush) {
+            const int over = from + Traits::kUp;
+            return to == over + Traits::kUp && (squareBB(over) & Traits::kDoublePushRank) != 0 &&
+                   (occupied & (squareBB(over) | to_bb)) == 0;
+        }
+        if (flag != MoveFlag::Quiet && !move.isPromotion()) {
+            return false;
+        }
+        return to == from + Traits::kUp && (occupied & to_bb) == 0;
+    }
+
+    if (move.isCastle()) {
+        constexpr int kFrom = Traits::kKingFrom;
+        constexpr Color kThem = Traits::kThem;
+        if (type != PieceType::King || from != kFrom) {
+            return false;
+        }
+        const bool king_side = flag == MoveFlag::KingCastle;
+        const int step = king_side ? 1 : -1;
+        const int right = king_side ? Traits::kKingSide : Traits::kQueenSide;
+        const Bitboard path = king_side ? squareBB(kFrom + 1) | squareBB(kFrom + 2)
+                                        : squareBB(kFrom - 1) | squareBB(kFrom - 2) | squareBB(kFrom - 3);
+        return to == kFrom + 2 * step && (board.castlePerm() & right) != 0 && (occupied & path) == 0 &&
+               !board.isSquareAttacked<kThem>(static_cast<Square>(kFrom + step), occupied) &&
+               !board.isSquareAttacked<kThem>(static_cast<Square>(kFrom + 2 * step), occupied);
+    }
+
+    // Pieces only move with the quiet and capture flags.
+    if (flag != (((theirs & to_bb) != 0) ? MoveFlag::Capture : MoveFlag::Quiet)) {
+        return false;
+    }
+    switch (type) {
+        case PieceType::Knight:
+            return (attacks::knight(move.from()) & to_bb) != 0;
+        case PieceType::Bishop:
+            return (attacks::bishop(move.from(), occupied) & to_bb) != 0;
+        case PieceType::Rook:
+            return (attacks::rook(move.from(), occupied) & to_bb) != 0;
+        case PieceType::Queen:
+            return (attacks::queen(move.from(), occupied) & to_bb) != 0;
+        case PieceType::King:
+            return (attacks::king(move.from()) & to_bb) != 0;
+        default:
+            return false;
+    }
+}
+
+// A pseudo-legal move is legal unless it leaves our king attacked: the same
+// king, pin and check rules the generators apply, for one move.
+template <Color Us>
+bool legal(const Board& board, Move move) noexcept {
+    if (!pseudoLegal<Us>(board, move)) {
+        return false;
+    }
+
+    const GenContext ctx = makeContext<Us>(board);
+    const int from = static_cast<int>(move.from());
+    const int to = static_cast<int>(move.to());
+    if (move.isCastle()) {
+        return ctx.checkers == 0;
+    }
+    if (move.from() == ctx.kingSq) {
+        return !board.isSquareAttacked<SideTraits<Us>::kThem>(move.to(), ctx.occupied ^ squareBB(from));
+    }
+    if (move.isEnPassant()) {
+        return enPassantLegal<Us>(board, ctx, from, to);
+    }
+    if ((ctx.pinned & squareBB(from)) != 0 && (attacks::line(ctx.kingSq, move.from()) & squareBB(to)) == 0) {
+        return false;
+    }
+    if (ctx.checkers == 0) {
+        return true;
+    }
+    if (moreThanOne(ctx.checkers)) {
+        return false;
+    }
+    Bitboard checkers = ctx.checkers;
+    const auto checker = static_cast<Square>(bitboard::popBit(checkers));
+    return ((attacks::between(ctx.kingSq, checker) | ctx.checkers) & squareBB(to)) != 0;
+}
+
+template <Color Us>
+void generate(const Board& board, MoveList& list, GenType type) noexcept {
     list.clear();
+    const GenContext ctx = makeContext<Us>(board);
+    if (ctx.checkers != 0) {
+        generateEvasions<Us>(board, ctx, list, type);
+    } else {
+        generateNonEvasions<Us>(board, ctx, list, type);
+    }
+}
+} // namespace
+
+template <Color Us>
+void generateAllMoves(const Board& board, MoveList& list) noexcept {
+    generate<Us>(board, list, GenType::All);
 }
 
+template <Color Us>
 void generateAllCaptures(const Board& board, MoveList& list) noexcept {
-    static_cast<void>(board);
-    list.clear();
+    generate<Us>(board, list, GenType::Captures);
+}
+
+template <Color Us>
+void generateQuiets(const Board& board, MoveList& list) noexcept {
+    generate<Us>(board, list, GenType::Quiets);
 }
 
-bool MoveExists(Board& board, const Move& move) noexcept {
-    static_cast<void>(board);
-    static_cast<void>(move);
-    return false;
+template void generateAllMoves<Color::White>(const Board&, MoveList&) noexcept;
+template void generateAllMoves<Color::Black>(const Board&, MoveList&) noexcept;
+template void generateAllCaptures<Color::White>(const Board&, MoveList&) noexcept;
+template void generateAllCaptures<Color::Black>(const Board&, MoveList&) noexcept;
+template void generateQuiets<Color::White>(const Board&, MoveList&) noexcept;
+template void generateQuiets<Color::Black>(const Board&, MoveList&) noexcept;
+
+void generateAllMoves(const Board& board, MoveList& list) noexcept {
+    if (board.side() == Color::White) {
+        generate<Color::White>(board, list, GenType::All);
+    } else {
+        generate<Color::Black>(board, list, GenType::All);
+    }
 }
 
-void initMvvLva() noexcept {}
+void generateAllCaptures(const Board& board, MoveList& list) noexcept {
+    if (board.side() == Color::White) {
+        generate<Color::White>(board, list, GenType::Captures);
+    } else {
+        generate<Color::Black>(board, list, GenType::Captures);
+    }
+}
+
+void generateQuiets(const Board& board, MoveList& list) noexcept {
+    if (board.side() == Color::White) {
+        generate<Color::White>(board, list, GenType::Quiets);
+    } else {
+        generate<Color::Black>(board, list, GenType::Quiets);
+    }
+}
+
+bool isPseudoLegal(const Board& board, Move move) noexcept {
+    return board.side() == Color::White ? pseudoLegal<Color::White>(board, move)
+                                        : pseudoLegal<Color::Black>(board, move);
+}
+
+bool isLegal(const Board& board, Move move) noexcept {
+    return board.side() == Color::White ? legal<Color::White>(board, move) : legal<Color::Black>(board, move);
+}
+
+void initMvvLva() noexcept {
+    for (int attacker = static_cast<int>(Piece::WhitePawn);
+         attacker <= static_cast<int>(Piece::BlackKing); ++attacker) {
+        for (int victim = static_cast<int>(Piece::WhitePawn);
+             victim <= static_cast<int>(Piece::BlackKing); ++victim) {
+            g_mvvLvaScores[victim][attacker] = kVictimScore[victim] + 6 - (kVictimScore[attacker] / 100);
+        }
+    }
+}
 
 } // namespace chess::movegen
@@ -0,0 +1,63 @@
+#include "chess/perft.hpp"
+
+#include <format>
+#include <iostream>
+
+#include "chess/board.hpp"
+#include "chess/io.hpp"
+#include "chess/misc.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+
+namespace chess::perft {
+
+namespace {
+template <Color Us>
+std::uint64_t perftSide(Board& board, int depth) noexcept {
+    constexpr Color kThem = Us == Color::White ? Color::Black : Color::White;
+
+    MoveList list;
+    movegen::generateAllMoves<Us>(board, list);
+
+    if (depth <= 1) {
+        return depth == 1 ? static_cast<std::uint64_t>(list.size()) : 1ULL;
+    }
+
+    std::uint64_t nodes = 0;
+    for (const Move move : list) {
+        board.makeMove<Us>(move);
+        nodes += perftSide<kThem>(board, depth - 1);
+        board.takeMove<Us>();
+    }
+    return nodes;
+}
+} // namespace
+
+std::uint64_t perft(Board& board, int depth) noexcept {
+    return board.side() == Color::White ? perftSide<Color::White>(board, depth)
+                                        : perftSide<Color::Black>(board, depth);
+}
+
+void perftTest(Board& board, int depth) noexcept {
+    std::cout << std::format("\nStarting Test To Depth:{}\n", depth);
+
+    const int start = misc::getTimeMs();
+    MoveList list;
+    movegen::generateAllMoves(board, list);
+
+    std::uint64_t leaf_nodes = 0;
+    for (int index = 0; index < list.size(); ++index) {
+        const Move move = list[index];
+        board.makeMove(move);
+        const std::uint64_t nodes = perft(board, depth - 1);
+        board.takeMove();
+        leaf_nodes += nodes;
+        std::cout << std::format("move {} : {} : {}\n", index + 1, io::printMove(move), nodes);
+    }
+
+    std::cout << std::format("\nTest Complete : {} nodes visited in {}ms\n", leaf_nodes,
+                             misc::getTimeMs() - start)
+              << std::flush;
+}
+
+} // namespace chess::perft
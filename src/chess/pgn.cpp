@@ -0,0 +1,317 @@
+#include "chess/pgn.hpp"
+
+#include "chess/board.hpp"
+#include "chess/movegen.hpp"
+#include "chess/types.hpp"
+
+namespace chess::pgn {
+
+namespace {
+[[nodiscard]] constexpr bool isSpace(char ch) noexcept {
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+// Start of the line after pos, or text.size().
+[[nodiscard]] std::size_t nextLine(std::string_view text, std::size_t pos) noexcept {
+    const auto end = text.find('\n', pos);
+    return end == std::string_view::npos ? text.size() : end + 1;
+}
+
+[[nodiscard]] std::string_view trimEnd(std::string_view text) noexcept {
+    while (!text.empty() && isSpace(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Skips a brace comment, or a variation with anything nested in it.
+[[nodiscard]] std::size_t skipGroup(std::string_view text, std::size_t pos) noexcept {
+    if (text[pos] == '{') {
+        const auto end = text.find('}', pos);
+        return end == std::string_view::npos ? text.size() : end + 1;
+    }
+
+    int depth = 0;
+    while (pos < text.size()) {
+        const char ch = text[pos];
+        if (ch == '{') {
+            pos = skipGroup(text, pos);
+            continue;
+        }
+        if (ch == ';') {
+            pos = nextLine(text, pos);
+            continue;
+        }
+        ++pos;
+        if (ch == '(') {
+            ++depth;
+        } else if (ch == ')' && --depth == 0) {
+            break;
+        }
+    }
+    return pos;
+}
+
+[[nodiscard]] constexpr bool isResult(std::string_view token) noexcept {
+    return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+}
+
+[[nodiscard]] constexpr PieceType pieceTypeFromChar(char ch) noexcept {
+    switch (ch) {
+        case 'N':
+        case 'n':
+            return PieceType::Knight;
+        case 'B':
+        case 'b':
+            return PieceType::Bishop;
+        case 'R':
+        case 'r':
+            return PieceType::Rook;
+        case 'Q':
+        case 'q':
+            return PieceType::Queen;
+        case 'K':
+            return PieceType::King;
+        default:
+            return PieceType::None;
+    }
+}
+
+[[nodiscard]] Move findCastle(const Board& board, MoveFlag flag) noexcept {
+    MoveList list;
+    movegen::generateAllMoves(board, list);
+    for (int index = 0; index < list.size(); ++index) {
+        if (list[index].flag() == flag) {
+            return list[index];
+        }
+    }
+    return Move{};
+}
+} // namespace
+
+bool PgnReader::next(Game& game) noexcept {
+    while (pos_ < text_.size() && isSpace(text_[pos_])) {
+        ++pos_;
+    }
+    if (pos_ >= text_.size()) {
+        return false;
+    }
+
+    const std::size_t tags_start = pos_;
+    while (pos_ < text_.size() && text_[pos_] == '[') {
+        pos_ = nextLine(text_, pos_);
+    }
+    const std::size_t movetext_start = pos_;
+    while (pos_ < text_.size() && text_[pos_] != '[') {
+        pos_ = nextLine(text_, pos_);
+    }
+
+    game.tags = text_.substr(tags_start, movetext_start - tags_start);
+    game.movetext = trimEnd(text_.substr(movetext_start, pos_ - movetext_start));
+    return true;
+}
+
+bool MovetextReader::next(std::string_view& san) noexcept {
+    while (pos_ < text_.size()) {
+        const char ch = text_[pos_];
+        if (isSpace(ch)) {
+            ++pos_;
+            continue;
+        }
+        if (ch == '{' || ch == '(') {
+            pos_ = skipGroup(text_, pos_);
+            continue;
+        }
+        if (ch == ';' || ch == '%') {
+            pos_ = nextLine(text_, pos_);
+            continue;
+        }
+
+        const std::size_t start = pos_;
+        while (pos_ < text_.size() && !isSpace(text_[pos_]) && text_[pos_] != '{' && text_[pos_] != '(' &&
+               text_[pos_] != ')' && text_[pos_] != ';') {
+            ++pos_;
+        }
+        std::string_view token = text_.substr(start, pos_ - start);
+        if (token.empty()) {
+            // A stray ')'.
+            ++pos_;
+            continue;
+        }
+
+        if (isResult(token)) {
+            pos_ = text_.size();
+            return false;
+        }
+        if (token.front() == '$') {
+            continue;
+        }
+        if (token.front() >= '1' && token.front() <= '9') {
+            // Move number, possibly run together with the move ("12.e4").
+            const auto dots = token.find('.');
+            if (dots == std::string_view::npos) {
+                continue;
+            }
+            token.remove_prefix(dots);
+            while (!token.empty() && token.front() == '.') {
+                token.remove_prefix(1);
+            }
+            if (token.empty()) {
+                continue;
+            }
+        }
+        san = token;
+        return true;
+    }
+    return false;
+}
+
+std::string_view tagValue(std::string_view tags, std::string_view name) noexcept {
+    for (std::size_t pos = 0; pos < tags.size(); pos = nextLine(tags, pos)) {
+        std::string_view line = tags.substr(pos, nextLine(tags, pos) - pos);
+        if (line.size() < name.size() + 2 || line[0] != '[' || line.substr(1, name.size()) != name ||
+            !isSpace(line[name.size() + 1])) {
+            continue;
+        }
+        const auto open = line.find('"');
+        const auto close = line.rfind('"');
+        if (open == std::string_view::npos || close == open) {
+            return {};
+        }
+        return line.substr(open + 1, close - open - 1);
+    }
+    return {};
+}
+
+std::optional<binpos::GameResult> result(const Game& game) noexcept {
+    const std::string_view value = tagValue(game.tags, "Result");
+    if (value == "1-0") {
+        return binpos::GameResult::WhiteWin;
+    }
+    if (value == "0-1") {
+        return binpos::GameResult::BlackWin;
+    }
+    if (value == "1/2-1/2") {
+        return binpos::GameResult::Draw;
+    }
+    return std::nullopt;
+}
+
+bool setup(const Game& game, Board& board) noexcept {
+    const std::string_view fen = tagValue(game.tags, "FEN");
+    return board.parseFen(fen.empty() ? std::string_view(kStartFen) : fen);
+}
+
+Move parseSan(const Board& board, std::string_view san) noexcept {
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?')) {
+        san.remove_suffix(1);
+    }
+    if (san == "O-O" || san == "0-0") {
+        return findCastle(board, MoveFlag::KingCastle);
+    }
+    if (san == "O-O-O" || san == "0-0-0") {
+        return findCastle(board, MoveFlag::QueenCastle);
+    }
+    if (san.empty()) {
+        return Move{};
+    }
+
+    PieceType piece = PieceType::Pawn;
+    if (san.front() >= 'B' && san.front() <= 'R') {
+        piece = pieceTypeFromChar(san.front());
+        if (piece == PieceType::None) {
+            return Move{};
+        }
+        san.remove_prefix(1);
+    }
+
+    PieceType promotion = PieceType::None;
+    if (piece == PieceType::Pawn && !san.empty()) {
+        const PieceType last = pieceTypeFromChar(san.back());
+        if (last != PieceType::None && last != PieceType::King) {
+            promotion = last;
+            san.remove_suffix(1);
+            if (!san.empty() && san.back() == '=') {
+                san.remove_suffix(1);
+            }
+        }
+    }
+
+    if (san.size() < 2) {
+        return Move{};
+    }
+    const int to_file = san[san.size() - 2] - 'a';
+    const int to_rank = san[san.size() - 1] - '1';
+    if (to_file < 0 || to_file > 7 || to_rank < 0 || to_rank > 7) {
+        return Move{};
+    }
+    san.remove_suffix(2);
+
+    int from_file = -1;
+    int from_rank = -1;
+    for (const char ch : san) {
+        if (ch >= 'a' && ch <= 'h') {
+            from_file = ch - 'a';
+        } else if (ch >= '1' && ch <= '8') {
+            from_rank = ch - '1';
+        } else if (ch != 'x' && ch != ':' && ch != '-') {
+            return Move{};
+        }
+    }
+
+    MoveList list;
+    movegen::generateAllMoves(board, list);
+    Move found{};
+    const int to = to_rank * 8 + to_file;
+    for (int index = 0; index < list.size(); ++index) {
+        const Move move = list[index];
+        if (static_cast<int>(move.to()) != to || move.promoted() != promotion || move.isCastle() ||
+            typeOf(board.pieceAt(move.from())) != piece) {
+            continue;
+        }
+        if ((from_file >= 0 && static_cast<int>(fileOf(move.from())) != from_file) ||
+            (from_rank >= 0 && static_cast<int>(rankOf(move.from())) != from_rank)) {
+            continue;
+        }
+        if (found != Move{}) {
+            return Move{};
+        }
+        found = move;
+    }
+    return found;
+}
+
+std::vector<std::string_view> splitGames(std::string_view text, int count) {
+    std::vector<std::string_view> pieces;
+    std::size_t start = 0;
+    for (int piece = 1; piece <= count && start < text.size(); ++piece) {
+        std::size_t end = text.size();
+        if (piece < count) {
+            // The first tag-pair line after the nominal boundary whose
+            // previous line is not itself a tag pair.
+            end = text.size() * static_cast<std::size_t>(piece) / static_cast<std::size_t>(count);
+            end = end < start ? start : end;
+            while (true) {
+                end = text.find("\n[", end);
+                if (end == std::string_view::npos) {
+                    end = text.size();
+                    break;
+                }
+                const auto previous = text.rfind('\n', end == 0 ? 0 : end - 1);
+                const std::size_t line = previous == std::string_view::npos ? 0 : previous + 1;
+                if (line >= end || text[line] != '[') {
+                    ++end;
+                    break;
+                }
+                ++end;
+            }
+        }
+        if (end > start) {
+            pieces.push_back(text.substr(start, end - start));
+        }
+        start = end;
+    }
+    return pieces;
+}
+
+} // namespace chess::pgn
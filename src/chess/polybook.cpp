@@ -1,17 +1,166 @@
 #include "chess/polybook.hpp"
 
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <vector>
+
 #include "chess/board.hpp"
+#include "chess/mapped_file.hpp"
+#include "chess/movegen.hpp"
 #include "chess/types.hpp"
 
 namespace chess::polybook {
 
-void init() noexcept {}
+namespace {
+constexpr std::size_t kEntrySize = 16;
+// The first record: magic, then the format version and four zero bytes.
+constexpr std::string_view kMagic = "CHESSBOK";
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kHeaderSize = kEntrySize;
+
+MappedFile g_book;
+// Per thread, so that server sessions can probe the shared book concurrently.
+thread_local std::mt19937 g_random{std::random_device{}()};
+
+[[nodiscard]] std::uint64_t readBigEndian(const char* data, int bytes) noexcept {
+    std::uint64_t value = 0;
+    for (int index = 0; index < bytes; ++index) {
+        value = (value << 8) | static_cast<unsigned char>(data[index]);
+    }
+    return value;
+}
+
+void writeBigEndian(char* data, std::uint64_t value, int bytes) noexcept {
+    for (int index = bytes - 1; index >= 0; --index) {
+        data[index] = static_cast<char>(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+[[nodiscard]] std::size_t entryCount() noexcept {
+    return (g_book.size() - kHeaderSize) / kEntrySize;
+}
+
+[[nodiscard]] Entry entryAt(std::size_t index) noexcept {
+    const char* data = g_book.data().data() + kHeaderSize + index * kEntrySize;
+    return Entry{readBigEndian(data, 8), static_cast<std::uint16_t>(readBigEndian(data + 8, 2)),
+                 static_cast<std::uint16_t>(readBigEndian(data + 10, 2)),
+                 static_cast<std::uint32_t>(readBigEndian(data + 12, 4))};
+}
+
+[[nodiscard]] bool validHeader(std::string_view data) noexcept {
+    return data.size() >= kHeaderSize && (data.size() - kHeaderSize) % kEntrySize == 0 &&
+           data.starts_with(kMagic) && readBigEndian(data.data() + 8, 4) == kVersion &&
+           readBigEndian(data.data() + 12, 4) == 0;
+}
+} // namespace
+
+void init() noexcept {
+    open(kDefaultBook);
+}
+
+void clean() noexcept {
+    g_book.close();
+}
+
+bool open(const char* path) noexcept {
+    g_book.close();
+    if (!g_book.open(path)) {
+        return false;
+    }
+    if (!validHeader(g_book.data())) {
+        g_book.close();
+        std::fprintf(stderr, "book: %s is not a book written by `chess book`\n", path);
+        return false;
+    }
+    return true;
+}
+
+Move getBookMove(Board& board) noexcept {
+    if (!g_book.isOpen()) {
+        return Move{};
+    }
+
+    const std::uint64_t key = board.posKey();
+    std::size_t low = 0;
+    std::size_t high = entryCount();
+    while (low < high) {
+        const std::size_t mid = low + (high - low) / 2;
+        if (entryAt(mid).key < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    std::vector<Entry> entries;
+    std::uint32_t total = 0;
+    for (std::size_t index = low; index < entryCount(); ++index) {
+        const Entry entry = entryAt(index);
+        if (entry.key != key) {
+            break;
+        }
+        entries.push_back(entry);
+        total += entry.weight;
+    }
+    if (total == 0) {
+        return Move{};
+    }
+
+    std::uint32_t pick = std::uniform_int_distribution<std::uint32_t>(0, total - 1)(g_random);
+    for (const auto& entry : entries) {
+        if (pick < entry.weight) {
+            return decodeMove(board, entry.move);
+        }
+        pick -= entry.weight;
+    }
+    return Move{};
+}
+
+std::uint16_t encodeMove(Move move) noexcept {
+    const int from = static_cast<int>(move.from());
+    int to = static_cast<int>(move.to());
+    if (move.flag() == MoveFlag::KingCastle) {
+        to = from + 3;
+    } else if (move.flag() == MoveFlag::QueenCastle) {
+        to = from - 4;
+    }
+    // Polyglot numbers promotions knight = 1 .. queen = 4, as PieceType does from pawn.
+    const int promotion = move.isPromotion() ? static_cast<int>(move.promoted()) - static_cast<int>(PieceType::Pawn) : 0;
+    return static_cast<std::uint16_t>(to | (from << 6) | (promotion << 12));
+}
+
+Move decodeMove(const Board& board, std::uint16_t move) noexcept {
+    MoveList list;
+    movegen::generateAllMoves(board, list);
+    for (int index = 0; index < list.size(); ++index) {
+        if (encodeMove(list[index]) == move) {
+            return list[index];
+        }
+    }
+    return Move{};
+}
 
-void clean() noexcept {}
+bool writeBook(const char* path, std::span<const Entry> entries) noexcept {
+    std::FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
 
-int getBookMove(Board& board) noexcept {
-    static_cast<void>(board);
-    return kNoMove;
+    char data[kEntrySize];
+    kMagic.copy(data, kMagic.size());
+    writeBigEndian(data + 8, kVersion, 4);
+    writeBigEndian(data + 12, 0, 4);
+    bool ok = std::fwrite(data, 1, kHeaderSize, file) == kHeaderSize;
+    for (const auto& entry : entries) {
+        writeBigEndian(data, entry.key, 8);
+        writeBigEndian(data + 8, entry.move, 2);
+        writeBigEndian(data + 10, entry.weight, 2);
+        writeBigEndian(data + 12, entry.learn, 4);
+        ok = ok && std::fwrite(data, 1, kEntrySize, file) == kEntrySize;
+    }
+    return std::fclose(file) == 0 && ok;
 }
 
 } // namespace chess::polybook
@@ -0,0 +1,436 @@
+#include "chess/position.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+#include "chess/attacks.hpp"
+#include "chess/bitboard.hpp"
+#include "chess/hash.hpp"
+#include "chess/internal/data.hpp"
+#include "chess/types.hpp"
+
+namespace chess {
+
+struct PositionLayout {
+    static_assert(alignof(Position) == 64 && sizeof(Position) == 6 * 64);
+    // Everything make/unmake reads on every node shares the first lines.
+    static_assert(offsetof(Position, pieces_) <= 3 * 64);
+};
+
+void Position::reset() noexcept {
+    for (int index = 0; index < kBoardSquareCount; ++index) {
+        pieces_[index] = Piece::Empty;
+    }
+
+    for (int index = 0; index < 2; ++index) {
+        bigPce_[index] = 0;
+        majPce_[index] = 0;
+        minPce_[index] = 0;
+        material_[index] = 0;
+    }
+
+    for (int index = 0; index < 3; ++index) {
+        occupancy_[index] = 0ULL;
+    }
+
+    for (int index = 0; index < 13; ++index) {
+        pceNum_[index] = 0;
+        pieceBB_[index] = 0ULL;
+    }
+
+    kingSq_[0] = kingSq_[1] = Square::NoSquare;
+    side_ = Color::Both;
+    enPas_ = Square::NoSquare;
+    fiftyMove_ = 0;
+    castlePerm_ = 0;
+    posKey_ = 0ULL;
+}
+
+void Position::updateListsMaterial() noexcept {
+    for (int index = 0; index < kBoardSquareCount; ++index) {
+        Square sq = static_cast<Square>(index);
+        Piece piece = pieces_[index];
+        if (piece != Piece::Empty) {
+            Color col = static_cast<Color>(internal::kPieceCol[static_cast<int>(piece)]);
+
+            if (internal::kPieceBig[static_cast<int>(piece)] != 0) {
+                bigPce_[static_cast<int>(col)]++;
+                if (internal::kPieceMaj[static_cast<int>(piece)] != 0) {
+                    majPce_[static_cast<int>(col)]++;
+                } else {
+                    minPce_[static_cast<int>(col)]++;
+                }
+            }
+
+            material_[static_cast<int>(col)] += internal::kPieceVal[static_cast<int>(piece)];
+
+            pList_[static_cast<int>(piece)][pceNum_[static_cast<int>(piece)]] = sq;
+            pceNum_[static_cast<int>(piece)]++;
+
+            if (piece == Piece::WhiteKing) {
+                kingSq_[static_cast<int>(Color::White)] = sq;
+            }
+            if (piece == Piece::BlackKing) {
+                kingSq_[static_cast<int>(Color::Black)] = sq;
+            }
+
+            bitboard::setBit(pieceBB_[static_cast<int>(piece)], index);
+            bitboard::setBit(occupancy_[static_cast<int>(col)], index);
+            bitboard::setBit(occupancy_[static_cast<int>(Color::Both)], index);
+        }
+    }
+}
+
+bool Position::checkBoard() const noexcept {
+    std::array<int, 13> piece_count{};
+    std::array<int, 2> material{};
+    std::array<Bitboard, 13> piece_bb{};
+
+    for (int index = 0; index < kBoardSquareCount; ++index) {
+        const Piece piece = pieces_[index];
+        if (piece == Piece::Empty) {
+            continue;
+        }
+        ++piece_count[static_cast<int>(piece)];
+        material[internal::kPieceCol[static_cast<int>(piece)]] +=
+            internal::kPieceVal[static_cast<int>(piece)];
+        bitboard::setBit(piece_bb[static_cast<int>(piece)], index);
+    }
+
+    Bitboard white = 0ULL;
+    Bitboard black = 0ULL;
+    for (int index = static_cast<int>(Piece::WhitePawn); index <= static_cast<int>(Piece::BlackKing);
+         ++index) {
+        if (piece_count[index] != pceNum_[index] || piece_bb[index] != pieceBB_[index]) {
+            return false;
+        }
+        for (int num = 0; num < pceNum_[index]; ++num) {
+            if (pieces_[static_cast<int>(pList_[index][num])] != static_cast<Piece>(index)) {
+                return false;
+            }
+        }
+        (internal::kPieceCol[index] == static_cast<int>(Color::White) ? white : black) |=
+            piece_bb[index];
+    }
+
+    return white == occupancy_[static_cast<int>(Color::White)] &&
+           black == occupancy_[static_cast<int>(Color::Black)] &&
+           (white | black) == occupancy_[static_cast<int>(Color::Both)] &&
+           material[0] == material_[0] && material[1] == material_[1] &&
+           (side_ == Color::White || side_ == Color::Black) &&
+           posKey_ == hash::generatePositionKey(*this);
+}
+
+Bitboard Position::attackersTo(Square sq, Bitboard occupied) const noexcept {
+    const auto bishops_queens = pieces(Piece::WhiteBishop) | pieces(Piece::BlackBishop) |
+                                pieces(Piece::WhiteQueen) | pieces(Piece::BlackQueen);
+    const auto rooks_queens = pieces(Piece::WhiteRook) | pieces(Piece::BlackRook) |
+                              pieces(Piece::WhiteQueen) | pieces(Piece::BlackQueen);
+
+    return (attacks::pawn(Color::Black, sq) & pieces(Piece::WhitePawn)) |
+           (attacks::pawn(Color::White, sq) & pieces(Piece::BlackPawn)) |
+           (attacks::knight(sq) & (pieces(Piece::WhiteKnight) | pieces(Piece::BlackKnight))) |
+           (attacks::king(sq) & (pieces(Piece::WhiteKing) | pieces(Piece::BlackKing))) |
+           (attacks::bishop(sq, occupied) & bishops_queens) |
+           (attacks::rook(sq, occupied) & rooks_queens);
+}
+
+bool Position::isSquareAttacked(Square sq, Color side) const noexcept {
+    assert(side == Color::White || side == Color::Black);
+    const Bitboard occupied = occupancy_[static_cast<int>(Color::Both)];
+    return side == Color::White ? isSquareAttacked<Color::White>(sq, occupied)
+                                : isSquareAttacked<Color::Black>(sq, occupied);
+}
+
+int Position::supportedCastlePerm(int perm) const noexcept {
+    struct Right {
+        CastleRights right;
+        Square king;
+        Square rook;
+        Piece kingPiece;
+        Piece rookPiece;
+    };
+    constexpr std::array<Right, 4> kRights = {{
+        {CastleRights::WhiteKingside, Square::E1, Square::H1, Piece::WhiteKing, Piece::WhiteRook},
+        {CastleRights::WhiteQueenside, Square::E1, Square::A1, Piece::WhiteKing, Piece::WhiteRook},
+        {CastleRights::BlackKingside, Square::E8, Square::H8, Piece::BlackKing, Piece::BlackRook},
+        {CastleRights::BlackQueenside, Square::E8, Square::A8, Piece::BlackKing, Piece::BlackRook},
+    }};
+
+    for (const Right& right : kRights) {
+        if (pieceAt(right.king) != right.kingPiece || pieceAt(right.rook) != right.rookPiece) {
+            perm &= ~static_cast<int>(right.right);
+        }
+    }
+    return perm;
+}
+
+bool Position::enPassantPossible(Square sq) const noexcept {
+    if (sq == Square::NoSquare) {
+        return true;
+    }
+    const bool white = side_ == Color::White;
+    if (static_cast<int>(sq) >= kBoardSquareCount || rankOf(sq) != (white ? Rank::R6 : Rank::R3)) {
+        return false;
+    }
+    const int forward = white ? 8 : -8;
+    const int index = static_cast<int>(sq);
+    return pieceAt(sq) == Piece::Empty && pieceAt(static_cast<Square>(index + forward)) == Piece::Empty &&
+           pieceAt(static_cast<Square>(index - forward)) == (white ? Piece::BlackPawn : Piece::WhitePawn);
+}
+
+void Position::addPiece(Square sq, Piece pce) noexcept {
+    const int index = static_cast<int>(pce);
+    const int col = internal::kPieceCol[index];
+
+    posKey_ ^= internal::g_pieceKeys[index][static_cast<int>(sq)];
+    pieces_[static_cast<int>(sq)] = pce;
+
+    if (internal::kPieceBig[index] != 0) {
+        bigPce_[col]++;
+        if (internal::kPieceMaj[index] != 0) {
+            majPce_[col]++;
+        } else {
+            minPce_[col]++;
+        }
+    }
+
+    material_[col] += internal::kPieceVal[index];
+    pList_[index][pceNum_[index]++] = sq;
+
+    if (internal::isKing(pce)) {
+        kingSq_[col] = sq;
+    }
+
+    bitboard::setBit(pieceBB_[index], static_cast<int>(sq));
+    bitboard::setBit(occupancy_[col], static_cast<int>(sq));
+    bitboard::setBit(occupancy_[static_cast<int>(Color::Both)], static_cast<int>(sq));
+}
+
+void Position::clearPiece(Square sq) noexcept {
+    const Piece pce = pieces_[static_cast<int>(sq)];
+    const int index = static_cast<int>(pce);
+    const int col = internal::kPieceCol[index];
+    assert(pce != Piece::Empty);
+
+    posKey_ ^= internal::g_pieceKeys[index][static_cast<int>(sq)];
+    pieces_[static_cast<int>(sq)] = Piece::Empty;
+
+    if (internal::kPieceBig[index] != 0) {
+        bigPce_[col]--;
+        if (internal::kPieceMaj[index] != 0) {
+            majPce_[col]--;
+        } else {
+            minPce_[col]--;
+        }
+    }
+
+    material_[col] -= internal::kPieceVal[index];
+
+    // Swap the last list entry into the removed slot.
+    for (int num = 0; num < pceNum_[index]; ++num) {
+        if (pList_[index][num] == sq) {
+            pList_[index][num] = pList_[index][--pceNum_[index]];
+            break;
+        }
+    }
+
+    bitboard::clearBit(pieceBB_[index], static_cast<int>(sq));
+    bitboard::clearBit(occupancy_[col], static_cast<int>(sq));
+    bitboard::clearBit(occupancy_[static_cast<int>(Color::Both)], static_cast<int>(sq));
+}
+
+void Position::movePiece(Square from, Square to) noexcept {
+    const Piece pce = pieces_[static_cast<int>(from)];
+    const int index = static_cast<int>(pce);
+    const int col = internal::kPieceCol[index];
+    const Bitboard from_to = (1ULL << static_cast<int>(from)) | (1ULL << static_cast<int>(to));
+
+    posKey_ ^= internal::g_pieceKeys[index][static_cast<int>(from)] ^
+               internal::g_pieceKeys[index][static_cast<int>(to)];
+    pieces_[static_cast<int>(from)] = Piece::Empty;
+    pieces_[static_cast<int>(to)] = pce;
+
+    for (int num = 0; num < pceNum_[index]; ++num) {
+        if (pList_[index][num] == from) {
+            pList_[index][num] = to;
+            break;
+        }
+    }
+
+    if (internal::isKing(pce)) {
+        kingSq_[col] = to;
+    }
+
+    pieceBB_[index] ^= from_to;
+    occupancy_[col] ^= from_to;
+    occupancy_[static_cast<int>(Color::Both)] ^= from_to;
+}
+
+void Position::hashState() noexcept {
+    if (side_ == Color::White) {
+        posKey_ ^= internal::g_sideKey;
+    }
+    if (enPas_ != Square::NoSquare) {
+        posKey_ ^= internal::g_pieceKeys[static_cast<int>(Piece::Empty)][static_cast<int>(enPas_)];
+    }
+    posKey_ ^= internal::g_castleKeys[castlePerm_];
+}
+
+namespace {
+// Castle rights that survive a move touching each square.
+constexpr std::array<int, kBoardSquareCount> kCastlePerm = {
+    13, 15, 15, 15, 12, 15, 15, 14, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15, 7,  15, 15, 15, 3,  15, 15, 11};
+
+// Rook from/to squares for castling by the given side.
+template <Color Us>
+[[nodiscard]] constexpr std::pair<Square, Square> castleRookSquares(bool kingSide) noexcept {
+    if constexpr (Us == Color::White) {
+        return kingSide ? std::pair{Square::H1, Square::F1} : std::pair{Square::A1, Square::D1};
+    } else {
+        return kingSide ? std::pair{Square::H8, Square::F8} : std::pair{Square::A8, Square::D8};
+    }
+}
+
+[[nodiscard]] inline std::uint64_t enPasKey(Square sq) noexcept {
+    return internal::g_pieceKeys[static_cast<int>(Piece::Empty)][static_cast<int>(sq)];
+}
+} // namespace
+
+template <Color Us>
+void Position::doMove(Move move) noexcept {
+    constexpr Color kThem = Us == Color::White ? Color::Black : Color::White;
+    constexpr int kDown = Us == Color::White ? -8 : 8;
+    assert(side_ == Us);
+    assert(checkBoard());
+
+    const Square from = move.from();
+    const Square to = move.to();
+    const Piece moved = pieces_[static_cast<int>(from)];
+    const Piece captured_pce = captured(move);
+
+    if (move.isEnPassant()) {
+        clearPiece(static_cast<Square>(static_cast<int>(to) + kDown));
+    } else if (move.isCastle()) {
+        const auto [rook_from, rook_to] = castleRookSquares<Us>(move.flag() == MoveFlag::KingCastle);
+        movePiece(rook_from, rook_to);
+    }
+
+    if (enPas_ != Square::NoSquare) {
+        posKey_ ^= enPasKey(enPas_);
+    }
+    posKey_ ^= internal::g_castleKeys[castlePerm_];
+    castlePerm_ &= kCastlePerm[static_cast<int>(from)] & kCastlePerm[static_cast<int>(to)];
+    posKey_ ^= internal::g_castleKeys[castlePerm_];
+    enPas_ = Square::NoSquare;
+
+    ++fiftyMove_;
+    if (captured_pce != Piece::Empty && !move.isEnPassant()) {
+        clearPiece(to);
+    }
+    if (captured_pce != Piece::Empty || moved == pieceOf(Us, PieceType::Pawn)) {
+        fiftyMove_ = 0;
+    }
+
+    if (move.isPawnStart()) {
+        enPas_ = static_cast<Square>(static_cast<int>(to) + kDown);
+        posKey_ ^= enPasKey(enPas_);
+    }
+
+    movePiece(from, to);
+
+    if (move.isPromotion()) {
+        clearPiece(to);
+        addPiece(to, pieceOf(Us, move.promoted()));
+    }
+
+    side_ = kThem;
+    posKey_ ^= internal::g_sideKey;
+
+    assert(checkBoard());
+}
+
+template <Color Us>
+void Position::undoMove(const Undo& undo) noexcept {
+    constexpr int kDown = Us == Color::White ? -8 : 8;
+    assert(side_ != Us);
+    assert(checkBoard());
+
+    const Move move = undo.move();
+    const Square from = move.from();
+    const Square to = move.to();
+
+    if (enPas_ != Square::NoSquare) {
+        posKey_ ^= enPasKey(enPas_);
+    }
+    posKey_ ^= internal::g_castleKeys[castlePerm_];
+
+    castlePerm_ = undo.castlePerm();
+    fiftyMove_ = undo.fiftyMove();
+    enPas_ = undo.enPas();
+
+    if (enPas_ != Square::NoSquare) {
+        posKey_ ^= enPasKey(enPas_);
+    }
+    posKey_ ^= internal::g_castleKeys[castlePerm_];
+
+    side_ = Us;
+    posKey_ ^= internal::g_sideKey;
+
+    if (move.isPromotion()) {
+        clearPiece(to);
+        addPiece(to, pieceOf(Us, PieceType::Pawn));
+    }
+
+    movePiece(to, from);
+
+    if (move.isEnPassant()) {
+        addPiece(static_cast<Square>(static_cast<int>(to) + kDown), undo.captured());
+    } else if (move.isCastle()) {
+        const auto [rook_from, rook_to] = castleRookSquares<Us>(move.flag() == MoveFlag::KingCastle);
+        movePiece(rook_to, rook_from);
+    } else if (undo.captured() != Piece::Empty) {
+        addPiece(to, undo.captured());
+    }
+
+    assert(posKey_ == undo.posKey());
+    assert(checkBoard());
+}
+
+template void Position::doMove<Color::White>(Move) noexcept;
+template void Position::doMove<Color::Black>(Move) noexcept;
+template void Position::undoMove<Color::White>(const Undo&) noexcept;
+template void Position::undoMove<Color::Black>(const Undo&) noexcept;
+
+void Position::doNullMove() noexcept {
+    if (enPas_ != Square::NoSquare) {
+        posKey_ ^= enPasKey(enPas_);
+    }
+    enPas_ = Square::NoSquare;
+
+    side_ = side_ == Color::White ? Color::Black : Color::White;
+    posKey_ ^= internal::g_sideKey;
+}
+
+void Position::undoNullMove(const Undo& undo) noexcept {
+    castlePerm_ = undo.castlePerm();
+    fiftyMove_ = undo.fiftyMove();
+    enPas_ = undo.enPas();
+    side_ = side_ == Color::White ? Color::Black : Color::White;
+    posKey_ = undo.posKey();
+}
+
+void Position::saveUndo(Undo& undo, Move move) const noexcept {
+    undo.setPosKey(posKey_);
+    undo.setMove(move);
+    undo.setCaptured(captured(move));
+    undo.setCastlePerm(castlePerm_);
+    undo.setEnPas(enPas_);
+    undo.setFiftyMove(fiftyMove_);
+}
+
+} // namespace chess
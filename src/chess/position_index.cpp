@@ -0,0 +1,573 @@
+#include "chess/position_index.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string_view>
+#include <thread>
+
+#include "chess/board.hpp"
+#include "chess/misc.hpp"
+#include "chess/pgn.hpp"
+#include "chess/types.hpp"
+
+namespace chess::posindex {
+
+static_assert(std::endian::native == std::endian::little, "index files are written in native byte order");
+
+namespace {
+constexpr std::array<char, 8> kMagic = {'C', 'H', 'E', 'S', 'S', 'I', 'D', 'X'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kBlockPostings = 256;
+// Positions with at least this many postings get precomputed move stats.
+constexpr std::uint32_t kStatsThreshold = 2 * kBlockPostings;
+constexpr std::uint8_t kNoResult = 3;
+constexpr int kChunksPerThread = 8;
+
+// File layout: header, posting blocks, stats records, block directory.
+struct FileHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t blockPostings;
+    std::uint64_t postings;
+    std::uint64_t blocks;
+    std::uint64_t statsOffset;
+    std::uint64_t statsCount;
+    std::uint64_t directoryOffset;
+};
+
+struct DirectoryEntry {
+    std::uint64_t firstKey;
+    std::uint64_t offset;
+};
+
+struct StatsRecord {
+    std::uint64_t key;
+    std::uint16_t move;
+    std::uint16_t reserved;
+    std::uint32_t games;
+    std::uint32_t whiteWins;
+    std::uint32_t draws;
+    std::uint32_t blackWins;
+    std::uint32_t padding;
+};
+
+static_assert(sizeof(FileHeader) == 56);
+static_assert(sizeof(DirectoryEntry) == 16);
+static_assert(sizeof(StatsRecord) == 32);
+
+// Uncompressed posting as sorted in memory and spilled to run files.
+struct RunPosting {
+    std::uint64_t key;
+    std::uint64_t game;
+    std::uint16_t move;
+    std::uint8_t result;
+    std::array<std::uint8_t, 5> padding;
+};
+
+static_assert(sizeof(RunPosting) == 24);
+
+[[nodiscard]] bool postingLess(const RunPosting& lhs, const RunPosting& rhs) noexcept {
+    return lhs.key != rhs.key ? lhs.key < rhs.key : lhs.game < rhs.game;
+}
+
+void putVarint(std::vector<char>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Returns false on a truncated value.
+bool getVarint(const char*& data, const char* end, std::uint64_t& value) noexcept {
+    value = 0;
+    for (int shift = 0; data < end && shift < 64; shift += 7) {
+        const auto byte = static_cast<unsigned char>(*data++);
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+[[nodiscard]] T readAt(std::string_view data, std::uint64_t offset) noexcept {
+    T value;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+
+[[nodiscard]] std::uint8_t resultCode(std::optional<binpos::GameResult> result) noexcept {
+    return result ? static_cast<std::uint8_t>(*result) : kNoResult;
+}
+
+[[nodiscard]] std::optional<binpos::GameResult> resultFromCode(std::uint64_t code) noexcept {
+    return code == kNoResult ? std::nullopt : std::optional(static_cast<binpos::GameResult>(code));
+}
+
+void addResult(MoveStats& stats, std::optional<binpos::GameResult> result) noexcept {
+    ++stats.games;
+    if (result == binpos::GameResult::WhiteWin) {
+        ++stats.whiteWins;
+    } else if (result == binpos::GameResult::Draw) {
+        ++stats.draws;
+    } else if (result == binpos::GameResult::BlackWin) {
+        ++stats.blackWins;
+    }
+}
+
+MoveStats& statsFor(std::vector<MoveStats>& stats, Move move) {
+    auto it = std::ranges::find(stats, move, &MoveStats::move);
+    if (it == stats.end()) {
+        stats.push_back({move, 0, 0, 0, 0});
+        return stats.back();
+    }
+    return *it;
+}
+
+// Sorted postings spilled to numbered temporary files.
+class RunSet {
+public:
+    explicit RunSet(std::string prefix) : prefix_(std::move(prefix)) {}
+
+    bool write(std::vector<RunPosting>& postings) {
+        std::ranges::sort(postings, postingLess);
+        std::string path;
+        {
+            std::lock_guard lock(mutex_);
+            path = std::format("{}.run{}", prefix_, paths_.size());
+            paths_.push_back(path);
+        }
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        const bool written = std::fwrite(postings.data(), sizeof(RunPosting), postings.size(), file) == postings.size();
+        postings.clear();
+        return std::fclose(file) == 0 && written;
+    }
+
+    [[nodiscard]] const std::vector<std::string>& paths() const noexcept { return paths_; }
+
+    void remove() noexcept {
+        for (const auto& path : paths_) {
+            std::remove(path.c_str());
+        }
+    }
+
+private:
+    std::string prefix_;
+    std::mutex mutex_;
+    std::vector<std::string> paths_;
+};
+
+struct Counters {
+    std::atomic<std::uint64_t> games{0};
+    std::atomic<std::uint64_t> errors{0};
+    std::atomic<bool> failed{false};
+};
+
+void indexChunk(std::string_view text, std::string_view archive, const BuildOptions& options, Board& board,
+                std::vector<RunPosting>& postings, std::size_t capacity, RunSet& runs, Counters& counters) {
+    pgn::PgnReader reader(text);
+    pgn::Game game;
+    while (reader.next(game)) {
+        const char* start = game.tags.empty() ? game.movetext.data() : game.tags.data();
+        const auto game_id = static_cast<std::uint64_t>(start - archive.data());
+        const std::uint8_t result = resultCode(pgn::result(game));
+        if (!pgn::setup(game, board)) {
+            counters.errors.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        pgn::MovetextReader moves(game.movetext);
+        std::string_view san;
+        bool ended = true;
+        for (int ply = 0; moves.next(san); ++ply) {
+            if ((options.maxPly > 0 && ply >= options.maxPly) || board.hisPly() >= kMaxGameMoves - 1) {
+                ended = false;
+                break;
+            }
+            const Move move = pgn::parseSan(board, san);
+            if (move == Move{}) {
+                counters.errors.fetch_add(1, std::memory_order_relaxed);
+                ended = false;
+                break;
+            }
+            postings.push_back({board.posKey(), game_id, static_cast<std::uint16_t>(move.value()), result, {}});
+            board.makeMove(move);
+        }
+        // The final position is indexed with no move.
+        if (ended) {
+            postings.push_back({board.posKey(), game_id, static_cast<std::uint16_t>(Move{}.value()), result, {}});
+        }
+        counters.games.fetch_add(1, std::memory_order_relaxed);
+
+        if (postings.size() >= capacity && !runs.write(postings)) {
+            counters.failed.store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+// Streams merged postings into compressed blocks.
+class IndexWriter {
+public:
+    bool open(const char* path) {
+        file_ = std::fopen(path, "wb");
+        if (file_ == nullptr) {
+            return false;
+        }
+        const FileHeader header{};
+        offset_ = sizeof(FileHeader);
+        return std::fwrite(&header, sizeof(header), 1, file_) == 1;
+    }
+
+    void add(const RunPosting& posting) {
+        if (posting.key != statsKey_ || postings_ == 0) {
+            closeKey();
+            statsKey_ = posting.key;
+        }
+        ++keyPostings_;
+        addResult(statsFor(keyStats_, Move(posting.move)), resultFromCode(posting.result));
+
+        if (block_.size() == kBlockPostings) {
+            flushBlock();
+        }
+        block_.push_back(posting);
+        ++postings_;
+    }
+
+    bool finish() {
+        closeKey();
+        flushBlock();
+
+        FileHeader header{};
+        header.magic = kMagic;
+        header.version = kVersion;
+        header.blockPostings = kBlockPostings;
+        header.postings = postings_;
+        header.blocks = directory_.size();
+        header.statsOffset = offset_;
+        header.statsCount = stats_.size();
+        header.directoryOffset = offset_ + stats_.size() * sizeof(StatsRecord);
+
+        bool ok = write(stats_.data(), stats_.size() * sizeof(StatsRecord)) &&
+                  write(directory_.data(), directory_.size() * sizeof(DirectoryEntry)) &&
+                  std::fseek(file_, 0, SEEK_SET) == 0 && write(&header, sizeof(header));
+        ok = std::fclose(file_) == 0 && ok && !failed_;
+        file_ = nullptr;
+        return ok;
+    }
+
+    [[nodiscard]] std::uint64_t postings() const noexcept { return postings_; }
+
+private:
+    bool write(const void* data, std::size_t size) {
+        if (size != 0 && std::fwrite(data, 1, size, file_) != size) {
+            failed_ = true;
+        }
+        offset_ += size;
+        return !failed_;
+    }
+
+    void closeKey() {
+        if (keyPostings_ >= kStatsThreshold) {
+            for (const auto& stats : keyStats_) {
+                stats_.push_back({statsKey_, static_cast<std::uint16_t>(stats.move.value()), 0, stats.games,
+                                  stats.whiteWins, stats.draws, stats.blackWins, 0});
+            }
+        }
+        keyStats_.clear();
+        keyPostings_ = 0;
+    }
+
+    // Block body: count, then per posting the key delta, the game (as a
+    // delta when the key repeats) and move << 2 | result, all varints.
+    void flushBlock() {
+        if (block_.empty()) {
+            return;
+        }
+        directory_.push_back({block_.front().key, offset_});
+        buffer_.clear();
+        putVarint(buffer_, block_.size());
+        std::uint64_t key = block_.front().key;
+        std::uint64_t game = 0;
+        for (std::size_t index = 0; index < block_.size(); ++index) {
+            const RunPosting& posting = block_[index];
+            const std::uint64_t key_delta = posting.key - key;
+            putVarint(buffer_, key_delta);
+            putVarint(buffer_, index > 0 && key_delta == 0 ? posting.game - game : posting.game);
+            putVarint(buffer_, static_cast<std::uint64_t>(posting.move) << 2 | posting.result);
+            key = posting.key;
+            game = posting.game;
+        }
+        write(buffer_.data(), buffer_.size());
+        block_.clear();
+    }
+
+    std::FILE* file_ = nullptr;
+    std::uint64_t offset_ = 0;
+    std::uint64_t postings_ = 0;
+    bool failed_ = false;
+    std::vector<RunPosting> block_;
+    std::vector<char> buffer_;
+    std::vector<DirectoryEntry> directory_;
+    std::vector<StatsRecord> stats_;
+    std::uint64_t statsKey_ = 0;
+    std::uint32_t keyPostings_ = 0;
+    std::vector<MoveStats> keyStats_;
+};
+
+// K-way merge of the sorted runs, keeping one posting per (key, game).
+bool mergeRuns(const RunSet& runs, IndexWriter& writer) {
+    std::vector<MappedFile> files(runs.paths().size());
+    for (std::size_t run = 0; run < files.size(); ++run) {
+        if (!files[run].open(runs.paths()[run].c_str())) {
+            return false;
+        }
+    }
+
+    struct Cursor {
+        RunPosting posting;
+        std::size_t run;
+        std::size_t next;
+    };
+    auto later = [](const Cursor& lhs, const Cursor& rhs) { return postingLess(rhs.posting, lhs.posting); };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> heap(later);
+
+    auto push = [&](std::size_t run, std::size_t index) {
+        if ((index + 1) * sizeof(RunPosting) <= files[run].size()) {
+            heap.push({readAt<RunPosting>(files[run].data(), index * sizeof(RunPosting)), run, index + 1});
+        }
+    };
+    for (std::size_t run = 0; run < files.size(); ++run) {
+        push(run, 0);
+    }
+
+    bool first = true;
+    RunPosting last{};
+    while (!heap.empty()) {
+        const Cursor cursor = heap.top();
+        heap.pop();
+        if (first || cursor.posting.key != last.key || cursor.posting.game != last.game) {
+            writer.add(cursor.posting);
+            last = cursor.posting;
+            first = false;
+        }
+        push(cursor.run, cursor.next);
+    }
+    return true;
+}
+} // namespace
+
+bool build(const BuildOptions& options) {
+    MappedFile archive;
+    if (!archive.open(options.input.c_str())) {
+        std::cout << std::format("index: cannot read {}\n", options.input);
+        return false;
+    }
+
+    const int start = misc::getTimeMs();
+    const int threads = options.threads > 0 ? options.threads : 1;
+    const auto chunks = pgn::splitGames(archive.data(), threads * kChunksPerThread);
+    const std::size_t capacity = std::max<std::size_t>(
+        1, static_cast<std::size_t>(options.memoryMb) * 1024 * 1024 / sizeof(RunPosting) / static_cast<std::size_t>(threads));
+
+    RunSet runs(options.output);
+    Counters counters;
+    std::atomic<std::size_t> next_chunk{0};
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<std::size_t>(threads));
+    for (int thread = 0; thread < threads; ++thread) {
+        workers.emplace_back([&] {
+            auto board = std::make_unique<Board>();
+            std::vector<RunPosting> postings;
+            postings.reserve(capacity);
+            std::size_t chunk;
+            while ((chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) < chunks.size()) {
+                indexChunk(chunks[chunk], archive.data(), options, *board, postings, capacity, runs, counters);
+            }
+            if (!postings.empty() && !runs.write(postings)) {
+                counters.failed.store(true, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    IndexWriter writer;
+    bool ok = !counters.failed.load() && writer.open(options.output.c_str());
+    if (ok) {
+        ok = mergeRuns(runs, writer);
+        ok = writer.finish() && ok;
+    }
+    runs.remove();
+    if (!ok) {
+        std::cout << std::format("index: cannot write {}\n", options.output);
+        return false;
+    }
+
+    std::cout << std::format("index: {} games ({} with bad moves), {} postings from {} runs in {} ms\n",
+                             counters.games.load(), counters.errors.load(), writer.postings(),
+                             runs.paths().size(), misc::getTimeMs() - start)
+              << std::flush;
+    return true;
+}
+
+bool PositionIndex::open(const char* path) noexcept {
+    if (!file_.open(path)) {
+        return false;
+    }
+    const std::string_view data = file_.data();
+    if (data.size() < sizeof(FileHeader)) {
+        file_.close();
+        return false;
+    }
+    const auto header = readAt<FileHeader>(data, 0);
+    const bool valid = header.magic == kMagic && header.version == kVersion &&
+                       header.statsOffset <= header.directoryOffset &&
+                       header.statsOffset + header.statsCount * sizeof(StatsRecord) == header.directoryOffset &&
+                       header.directoryOffset + header.blocks * sizeof(DirectoryEntry) == data.size();
+    if (!valid) {
+        file_.close();
+    }
+    return valid;
+}
+
+void PositionIndex::close() noexcept {
+    file_.close();
+}
+
+std::uint64_t PositionIndex::postingCount() const noexcept {
+    return isOpen() ? readAt<FileHeader>(file_.data(), 0).postings : 0;
+}
+
+template <typename Visit>
+void PositionIndex::scan(std::uint64_t key, Visit&& visit) const {
+    if (!isOpen()) {
+        return;
+    }
+    const std::string_view data = file_.data();
+    const auto header = readAt<FileHeader>(data, 0);
+    auto directory = [&](std::uint64_t block) {
+        return readAt<DirectoryEntry>(data, header.directoryOffset + block * sizeof(DirectoryEntry));
+    };
+
+    // First block starting at or after key; the one before may hold the
+    // key's first postings.
+    std::uint64_t low = 0;
+    std::uint64_t high = header.blocks;
+    while (low < high) {
+        const std::uint64_t mid = low + (high - low) / 2;
+        if (directory(mid).firstKey < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    for (std::uint64_t block = low > 0 ? low - 1 : 0; block < header.blocks; ++block) {
+        const DirectoryEntry entry = directory(block);
+        if (entry.firstKey > key) {
+            return;
+        }
+        const char* cursor = data.data() + entry.offset;
+        const char* end = data.data() + (block + 1 < header.blocks ? directory(block + 1).offset : header.statsOffset);
+
+        std::uint64_t count = 0;
+        std::uint64_t current = entry.firstKey;
+        std::uint64_t game = 0;
+        if (!getVarint(cursor, end, count)) {
+            return;
+        }
+        for (std::uint64_t index = 0; index < count; ++index) {
+            std::uint64_t key_delta = 0;
+            std::uint64_t game_value = 0;
+            std::uint64_t move_result = 0;
+            if (!getVarint(cursor, end, key_delta) || !getVarint(cursor, end, game_value) ||
+                !getVarint(cursor, end, move_result)) {
+                return;
+            }
+            current += key_delta;
+            game = index > 0 && key_delta == 0 ? game + game_value : game_value;
+            if (current > key) {
+                return;
+            }
+            if (current == key &&
+                !visit(Posting{game, Move(static_cast<int>(move_result >> 2)), resultFromCode(move_result & 3)})) {
+                return;
+            }
+        }
+    }
+}
+
+std::vector<MoveStats> PositionIndex::moveStats(std::uint64_t key) const {
+    std::vector<MoveStats> result;
+    if (!isOpen()) {
+        return result;
+    }
+
+    const std::string_view data = file_.data();
+    const auto header = readAt<FileHeader>(data, 0);
+    auto record = [&](std::uint64_t index) {
+        return readAt<StatsRecord>(data, header.statsOffset + index * sizeof(StatsRecord));
+    };
+    std::uint64_t low = 0;
+    std::uint64_t high = header.statsCount;
+    while (low < high) {
+        const std::uint64_t mid = low + (high - low) / 2;
+        if (record(mid).key < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (low < header.statsCount && record(low).key == key) {
+        for (std::uint64_t index = low; index < header.statsCount && record(index).key == key; ++index) {
+            const StatsRecord stats = record(index);
+            result.push_back({Move(stats.move), stats.games, stats.whiteWins, stats.draws, stats.blackWins});
+        }
+    } else {
+        scan(key, [&](const Posting& posting) {
+            addResult(statsFor(result, posting.move), posting.result);
+            return true;
+        });
+    }
+
+    std::ranges::sort(result, [](const MoveStats& lhs, const MoveStats& rhs) { return lhs.games > rhs.games; });
+    return result;
+}
+
+std::vector<MoveStats> PositionIndex::moveStats(const Board& board) const {
+    return moveStats(board.posKey());
+}
+
+std::vector<Posting> PositionIndex::games(std::uint64_t key, std::size_t limit) const {
+    std::vector<Posting> result;
+    if (limit == 0) {
+        return result;
+    }
+    scan(key, [&](const Posting& posting) {
+        result.push_back(posting);
+        return result.size() < limit;
+    });
+    return result;
+}
+
+std::vector<Posting> PositionIndex::games(const Board& board, std::size_t limit) const {
+    return games(board.posKey(), limit);
+}
+
+} // namespace chess::posindex
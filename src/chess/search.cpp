@@ -1,9 +1,14 @@
 #include "chess/search.hpp"
 
-#include <cstdio>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <span>
 
 #include "chess/board.hpp"
+#include "chess/evaluate.hpp"
 #include "chess/hash.hpp"
+#include "chess/io.hpp"
 #include "chess/misc.hpp"
 #include "chess/move.hpp"
 #include "chess/movegen.hpp"
@@ -13,37 +18,131 @@
 namespace chess::search {
 
 namespace {
-[[maybe_unused]] void checkUp(SearchInfo& info) noexcept {
+constexpr int kCheckUpInterval = 2048;
+constexpr int kNullMoveReduction = 4;
+constexpr int kDefaultMovesToGo = 30;
+constexpr int kMoveOverheadMs = 50;
+
+void checkUp(SearchInfo& info) noexcept {
     if (info.timeSet() && misc::getTimeMs() > info.stopTime()) {
         info.setStopped(true);
     }
-    misc::readInput(info);
+    if (info.nodeLimit() != 0 && info.nodes() >= info.nodeLimit()) {
+        info.setStopped(true);
+    }
+    if (info.stopSignal() != nullptr && info.stopSignal()->load(std::memory_order_relaxed)) {
+        info.setStopped(true);
+    }
+    if (info.ponder() && info.ponderHitSignal() != nullptr &&
+        info.ponderHitSignal()->load(std::memory_order_relaxed)) {
+        ponderHit(info);
+    }
+    if (info.pollInput()) {
+        misc::readInput(info);
+    }
 }
 
-[[maybe_unused]] void pickNextMove(int moveNum, MoveList& list) noexcept {
+void pickNextMove(int moveNum, MoveList& list) noexcept {
     if (moveNum >= list.size()) return;
 
-    int bestScore = list[moveNum].score();
+    int bestScore = list.score(moveNum);
     int bestNum = moveNum;
 
     for (int index = moveNum + 1; index < list.size(); ++index) {
-        if (list[index].score() > bestScore) {
-            bestScore = list[index].score();
+        if (list.score(index) > bestScore) {
+            bestScore = list.score(index);
             bestNum = index;
         }
     }
 
     if (bestNum != moveNum) {
-        Move temp = list[moveNum];
-        list[moveNum] = list[bestNum];
-        list[bestNum] = temp;
+        list.swap(moveNum, bestNum);
     }
 }
 
-[[maybe_unused]] bool isRepetition(const Board& board) noexcept {
+// Hands out a node's legal moves best first, in stages, so that a cutoff
+// saves generating the later ones: the hash move, captures by MVV-LVA, the
+// killers, then the remaining quiet moves by history. The hash move and
+// killers come from other positions and are checked with isLegal.
+class MovePicker {
+public:
+    MovePicker(const Board& board, Move hashMove) noexcept
+        : board_(board), hashMove_(hashMove),
+          killers_{board.searchKiller(0, board.ply()), board.searchKiller(1, board.ply())} {}
+
+    // Returns no move once every legal move has been returned.
+    Move next() noexcept {
+        for (;;) {
+            switch (stage_) {
+                case Stage::HashMove:
+                    stage_ = Stage::GenerateCaptures;
+                    if (hashMove_ != Move{} && movegen::isLegal(board_, hashMove_)) {
+                        return hashMove_;
+                    }
+                    break;
+                case Stage::GenerateCaptures:
+                    movegen::generateAllCaptures(board_, list_);
+                    index_ = 0;
+                    stage_ = Stage::Captures;
+                    break;
+                case Stage::Captures:
+                    if (const Move move = pick([](Move) { return false; }); move != Move{}) {
+                        return move;
+                    }
+                    stage_ = Stage::Killers;
+                    break;
+                case Stage::Killers:
+                    while (killer_ < static_cast<int>(killers_.size())) {
+                        const Move killer = killers_[killer_++];
+                        if (killer != Move{} && killer != hashMove_ && (killer_ == 1 || killer != killers_[0]) &&
+                            movegen::isLegal(board_, killer)) {
+                            return killer;
+                        }
+                    }
+                    stage_ = Stage::GenerateQuiets;
+                    break;
+                case Stage::GenerateQuiets:
+                    movegen::generateQuiets(board_, list_);
+                    index_ = 0;
+                    stage_ = Stage::Quiets;
+                    break;
+                case Stage::Quiets:
+                    // The killers were handed out already.
+                    return pick([this](Move move) { return move == killers_[0] || move == killers_[1]; });
+            }
+        }
+    }
+
+private:
+    enum class Stage { HashMove, GenerateCaptures, Captures, Killers, GenerateQuiets, Quiets };
+
+    // The best remaining move of list_ that is neither the hash move nor
+    // skipped, or no move.
+    template <typename Skip>
+    Move pick(Skip skip) noexcept {
+        while (index_ < list_.size()) {
+            pickNextMove(index_, list_);
+            const Move move = list_[index_++];
+            if (move != hashMove_ && !skip(move)) {
+                return move;
+            }
+        }
+        return Move{};
+    }
+
+    const Board& board_;
+    Move hashMove_;
+    std::array<Move, 2> killers_;
+    Stage stage_ = Stage::HashMove;
+    int killer_ = 0;
+    int index_ = 0;
+    MoveList list_;
+};
+
+bool isRepetition(const Board& board) noexcept {
     for (int index = board.hisPly() - board.fiftyMove(); index < board.hisPly() - 1; ++index) {
         if (index >= 0 && index < kMaxGameMoves) {
-            if (board.posKey() == board.history(index).posKey()) {
+            if (board.posKey() == board.historyKey(index)) {
                 return true;
             }
         }
@@ -60,21 +159,369 @@ void clearForSearch(Board& board, SearchInfo& info) noexcept {
 
     for (int index = 0; index < 2; ++index) {
         for (int index2 = 0; index2 < kMaxDepth; ++index2) {
-            board.searchKiller(static_cast<Color>(index), index2) = 0;
+            board.searchKiller(index, index2) = Move{};
         }
     }
 
-    board.hashTable().clear();
     board.setPly(0);
     info.setStopped(false);
     info.setNodes(0);
-    info.setFh(0.0f);
-    info.setFhf(0.0f);
+    info.setBestScore(0);
+    info.resetStats();
+}
+
+// Field-wise total - before, for the counters of one iteration.
+SearchStats difference(const SearchStats& total, const SearchStats& before) noexcept {
+    SearchStats result = total;
+    result.nodes -= before.nodes;
+    result.qnodes -= before.qnodes;
+    result.failHigh -= before.failHigh;
+    result.failHighFirst -= before.failHighFirst;
+    result.ttProbes -= before.ttProbes;
+    result.ttHits -= before.ttHits;
+    result.ttCuts -= before.ttCuts;
+    result.nullTries -= before.nullTries;
+    result.nullCuts -= before.nullCuts;
+    return result;
+}
+
+double percent(long part, long whole) noexcept {
+    return whole > 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+}
+
+// Nodes of this iteration over the previous one's; 0 for the first.
+double branchingFactor(const SearchStats& iteration, long previousNodes) noexcept {
+    return previousNodes > 0 ? static_cast<double>(iteration.nodes) / static_cast<double>(previousNodes) : 0.0;
+}
+
+void printIterationStats(std::ostream& out, const SearchStats& iteration, long previousNodes) {
+    misc::print(out, "info string stats depth {} nodes {} qnodes {} ebf {:.2f} fhf {:.1f}% tthit {:.1f}% "
+                "ttcut {:.1f}% nullcut {:.1f}%\n",
+                iteration.depth, iteration.nodes, iteration.qnodes, branchingFactor(iteration, previousNodes),
+                percent(iteration.failHighFirst, iteration.failHigh), percent(iteration.ttHits, iteration.ttProbes),
+                percent(iteration.ttCuts, iteration.ttProbes), percent(iteration.nullCuts, iteration.nullTries));
+}
+
+void printStatsFields(std::ostream& out, const SearchStats& stats) {
+    misc::print(out,
+                "\"depth\":{},\"nodes\":{},\"qnodes\":{},\"failHigh\":{},\"failHighFirst\":{},"
+                "\"ttProbes\":{},\"ttHits\":{},\"ttCuts\":{},\"nullTries\":{},\"nullCuts\":{}",
+                stats.depth, stats.nodes, stats.qnodes, stats.failHigh, stats.failHighFirst, stats.ttProbes,
+                stats.ttHits, stats.ttCuts, stats.nullTries, stats.nullCuts);
+}
+// Walks the hash moves from the root into pvArray; returns the line length.
+int getPvLine(Board& board, int depth) noexcept {
+    int count = 0;
+    Move move = board.hashTable().probePvMove(board.posKey());
+    while (move != Move{} && count < depth && movegen::isLegal(board, move)) {
+        board.makeMove(move);
+        board.pvArray(count++) = move;
+        move = board.hashTable().probePvMove(board.posKey());
+    }
+    while (board.ply() > 0) {
+        board.takeMove();
+    }
+    return count;
+}
+
+int staticEval(Board& board) noexcept {
+    EvalCache& cache = board.evalCache();
+    if (!cache.enabled()) {
+        return eval::evaluate(board);
+    }
+    int score = 0;
+    if (!cache.probe(board.posKey(), score)) {
+        score = eval::evaluate(board);
+        cache.store(board.posKey(), score);
+    }
+    return score;
+}
+
+int quiescence(int alpha, int beta, Board& board, SearchInfo& info) noexcept {
+    if ((info.nodes() & (kCheckUpInterval - 1)) == 0) {
+        checkUp(info);
+    }
+    info.incrementNodes();
+    ++info.stats().qnodes;
+
+    if (isRepetition(board) || board.fiftyMove() >= 100) {
+        return 0;
+    }
+    if (board.ply() > kMaxDepth - 1) {
+        return staticEval(board);
+    }
+
+    const int stand_pat = staticEval(board);
+    if (stand_pat >= beta) {
+        return beta;
+    }
+    if (stand_pat > alpha) {
+        alpha = stand_pat;
+    }
+
+    MoveList list;
+    movegen::generateAllCaptures(board, list);
+
+    for (int index = 0; index < list.size(); ++index) {
+        pickNextMove(index, list);
+        board.makeMove(list[index]);
+        board.evalCache().prefetch(board.posKey());
+        const int score = -quiescence(-beta, -alpha, board, info);
+        board.takeMove();
+
+        if (info.stopped()) {
+            return 0;
+        }
+        if (score > alpha) {
+            if (score >= beta) {
+                if (index == 0) {
+                    ++info.stats().failHighFirst;
+                }
+                ++info.stats().failHigh;
+                return beta;
+            }
+            alpha = score;
+        }
+    }
+    return alpha;
+}
+
+int alphaBeta(int alpha, int beta, int depth, Board& board, SearchInfo& info, bool doNull) noexcept {
+    if (depth <= 0) {
+        return quiescence(alpha, beta, board, info);
+    }
+
+    if ((info.nodes() & (kCheckUpInterval - 1)) == 0) {
+        checkUp(info);
+    }
+    info.incrementNodes();
+
+    if ((isRepetition(board) || board.fiftyMove() >= 100) && board.ply() > 0) {
+        return 0;
+    }
+    if (board.ply() > kMaxDepth - 1) {
+        return staticEval(board);
+    }
+
+    const Color us = board.side();
+    const Color them = us == Color::White ? Color::Black : Color::White;
+    const bool in_check = board.isSquareAttacked(board.kingSquare(us), them);
+    if (in_check) {
+        ++depth;
+    }
+
+    int score = -kInfinite;
+    Move pv_move{};
+    ++info.stats().ttProbes;
+    if (board.hashTable().probe(board.posKey(), board.ply(), pv_move, score, alpha, beta, depth)) {
+        board.hashTable().incrementCut();
+        return score;
+    }
+
+    if (doNull && !in_check && board.ply() > 0 && board.bigPiece(us) > 0 &&
+        depth >= kNullMoveReduction) {
+        ++info.stats().nullTries;
+        board.makeNullMove();
+        if (depth > kNullMoveReduction) {
+            board.hashTable().prefetch(board.posKey());
+        }
+        score = -alphaBeta(-beta, -beta + 1, depth - kNullMoveReduction, board, info, false);
+        board.takeNullMove();
+        if (info.stopped()) {
+            return 0;
+        }
+        if (score >= beta && std::abs(score) < kIsMate) {
+            ++info.stats().nullCuts;
+            return beta;
+        }
+    }
+
+    MovePicker picker(board, pv_move);
+    const int old_alpha = alpha;
+    Move best_move{};
+    int best_score = -kInfinite;
+    int moves_searched = 0;
+
+    for (Move move = picker.next(); move != Move{}; move = picker.next()) {
+        const bool first = moves_searched++ == 0;
+        board.makeMove(move);
+        // The child probes the table unless it drops into quiescence, which
+        // starts with the stand-pat evaluation.
+        if (depth > 1) {
+            board.hashTable().prefetch(board.posKey());
+        } else {
+            board.evalCache().prefetch(board.posKey());
+        }
+        score = -alphaBeta(-beta, -alpha, depth - 1, board, info, true);
+        board.takeMove();
+
+        if (info.stopped()) {
+            return 0;
+        }
+        if (score <= best_score) {
+            continue;
+        }
+        best_score = score;
+        best_move = move;
+        if (score <= alpha) {
+            continue;
+        }
+        if (score >= beta) {
+            if (first) {
+                ++info.stats().failHighFirst;
+            }
+            ++info.stats().failHigh;
+            if (!move.isCapture()) {
+                board.searchKiller(1, board.ply()) = board.searchKiller(0, board.ply());
+                board.searchKiller(0, board.ply()) = move;
+            }
+            board.hashTable().store(board.posKey(), board.ply(), best_move, beta, HashFlag::Beta, depth);
+            return beta;
+        }
+        alpha = score;
+        if (!move.isCapture()) {
+            board.searchHistory(board.pieceAt(move.from()), move.to()) += depth;
+        }
+    }
+
+    if (moves_searched == 0) {
+        return in_check ? -kInfinite + board.ply() : 0;
+    }
+    if (alpha != old_alpha) {
+        board.hashTable().store(board.posKey(), board.ply(), best_move, best_score, HashFlag::Exact, depth);
+    } else {
+        board.hashTable().store(board.posKey(), board.ply(), best_move, alpha, HashFlag::Alpha, depth);
+    }
+    return alpha;
 }
 } // namespace
 
-void searchPosition(Board& board, SearchInfo& info) noexcept {
+void applyLimits(const SearchLimits& limits, SearchInfo& info) noexcept {
+    int time = limits.timeMs;
+    int moves_to_go = limits.movesToGo > 0 ? limits.movesToGo : kDefaultMovesToGo;
+    if (limits.moveTimeMs >= 0) {
+        time = limits.moveTimeMs;
+        moves_to_go = 1;
+    }
+    const int budget = time >= 0 ? time / moves_to_go - kMoveOverheadMs + limits.incrementMs : -1;
+
+    info.setStartTime(misc::getTimeMs());
+    info.setDepth(limits.depth > 0 ? limits.depth : kMaxDepth);
+    info.setNodeLimit(limits.nodes);
+    info.setPonder(limits.ponder);
+    info.setPonderBudget(limits.ponder ? budget : -1);
+    info.setTimeSet(time >= 0 && !limits.ponder);
+    if (info.timeSet()) {
+        info.setStopTime(info.startTime() + budget);
+    }
+}
+
+void ponderHit(SearchInfo& info) noexcept {
+    info.setPonder(false);
+    if (info.ponderBudget() >= 0) {
+        info.setStopTime(misc::getTimeMs() + info.ponderBudget());
+        info.setTimeSet(true);
+    }
+}
+
+Move expectedReply(Board& board, Move best) noexcept {
+    if (best == Move{} || !movegen::isLegal(board, best)) {
+        return Move{};
+    }
+    board.makeMove(best);
+    Move reply = board.hashTable().probePvMove(board.posKey());
+    if (reply != Move{} && !movegen::isLegal(board, reply)) {
+        reply = Move{};
+    }
+    board.takeMove();
+    return reply;
+}
+
+void printStatsJson(std::ostream& out, const SearchInfo& info) {
+    out << '{';
+    printStatsFields(out, info.stats());
+    out << ",\"iterations\":[";
+    long previous_nodes = 0;
+    for (const SearchStats& iteration : info.iterationStats()) {
+        out << (previous_nodes == 0 ? "{" : ",{");
+        printStatsFields(out, iteration);
+        misc::print(out, ",\"ebf\":{:.2f}}}", branchingFactor(iteration, previous_nodes));
+        previous_nodes = iteration.nodes;
+    }
+    out << "]}";
+}
+
+Move searchPosition(Board& board, SearchInfo& info) noexcept {
     clearForSearch(board, info);
+
+    const HashTable& table = board.hashTable();
+    const int table_hits = table.hit();
+    const int table_cuts = table.cut();
+    // The probe counters live in the table; the rest are counted in place.
+    const auto update_totals = [&](int depth) {
+        SearchStats& stats = info.stats();
+        stats.depth = depth;
+        stats.nodes = info.nodes();
+        stats.ttHits = table.hit() - table_hits;
+        stats.ttCuts = table.cut() - table_cuts;
+    };
+
+    // Something legal to play even if the first iteration does not finish;
+    // no move when there is none.
+    MoveList root_moves;
+    movegen::generateAllMoves(board, root_moves);
+    Move best_move = root_moves.empty() ? Move{} : root_moves[0];
+    for (int depth = 1; depth <= info.depth(); ++depth) {
+        const SearchStats before = info.stats();
+        const int best_score = alphaBeta(-kInfinite, kInfinite, depth, board, info, true);
+        if (info.stopped()) {
+            break;
+        }
+        update_totals(depth);
+        info.addIterationStats(difference(info.stats(), before));
+
+        const int pv_moves = getPvLine(board, depth);
+        if (pv_moves > 0) {
+            best_move = board.pvArray(0);
+        }
+        info.setBestScore(best_score);
+
+        if (info.onIteration()) {
+            std::array<Move, kMaxDepth> pv{};
+            for (int index = 0; index < pv_moves; ++index) {
+                pv[index] = board.pvArray(index);
+            }
+            info.onIteration()(SearchIteration{depth, best_score, info.nodes(),
+                                               misc::getTimeMs() - info.startTime(),
+                                               std::span<const Move>{pv.data(), static_cast<std::size_t>(pv_moves)}});
+        }
+        if (info.postThinking()) {
+            std::ostream& out = info.output();
+            misc::print(out, "info score cp {} depth {} nodes {} time {} pv", best_score, depth, info.nodes(),
+                        misc::getTimeMs() - info.startTime());
+            for (int index = 0; index < pv_moves; ++index) {
+                out << ' ' << io::printMove(board.pvArray(index));
+            }
+            out << '\n';
+            if (info.reportStats()) {
+                const auto iterations = info.iterationStats();
+                printIterationStats(out, iterations.back(),
+                                    iterations.size() > 1 ? iterations[iterations.size() - 2].nodes : 0);
+            }
+            out << std::flush;
+        }
+    }
+
+    // Count the work of an interrupted iteration in the totals.
+    update_totals(info.stats().depth);
+    if (info.postThinking() && info.reportStats()) {
+        std::ostream& out = info.output();
+        out << "info string stats ";
+        printStatsJson(out, info);
+        out << '\n' << std::flush;
+    }
+
+    return best_move;
 }
 
 } // namespace chess::search
@@ -0,0 +1,287 @@
+#include "chess/server.hpp"
+
+#include <format>
+#include <iostream>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chess/board.hpp"
+#include "chess/hash.hpp"
+#include "chess/polybook.hpp"
+#include "chess/search_info.hpp"
+#include "chess/uci.hpp"
+#endif
+
+namespace chess::server {
+
+#ifdef _WIN32
+
+bool run(const Options& options) {
+    static_cast<void>(options);
+    std::cout << "server: sockets are only supported on POSIX systems\n";
+    return false;
+}
+
+#else
+
+namespace {
+constexpr std::size_t kBufferSize = 4096;
+constexpr int kListenBacklog = 64;
+
+// Buffered stream over a connected socket.
+class SocketBuffer : public std::streambuf {
+public:
+    explicit SocketBuffer(int fd) noexcept : fd_(fd) {
+        setg(in_.data(), in_.data(), in_.data());
+        setp(out_.data(), out_.data() + out_.size());
+    }
+    ~SocketBuffer() override { flushOutput(); }
+
+    SocketBuffer(const SocketBuffer&) = delete;
+    SocketBuffer& operator=(const SocketBuffer&) = delete;
+
+protected:
+    int_type underflow() override {
+        ssize_t count = 0;
+        do {
+            count = ::read(fd_, in_.data(), in_.size());
+        } while (count < 0 && errno == EINTR);
+        if (count <= 0) {
+            return traits_type::eof();
+        }
+        setg(in_.data(), in_.data(), in_.data() + count);
+        return traits_type::to_int_type(*gptr());
+    }
+
+    int_type overflow(int_type ch) override {
+        if (!flushOutput()) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int sync() override { return flushOutput() ? 0 : -1; }
+
+private:
+    bool flushOutput() noexcept {
+        const char* data = pbase();
+        std::size_t left = static_cast<std::size_t>(pptr() - pbase());
+        while (left > 0) {
+            const ssize_t written = ::write(fd_, data, left);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            left -= static_cast<std::size_t>(written);
+        }
+        setp(out_.data(), out_.data() + out_.size());
+        return true;
+    }
+
+    int fd_;
+    std::array<char, kBufferSize> in_{};
+    std::array<char, kBufferSize> out_{};
+};
+
+// Accepted connections waiting for a free session.
+class ConnectionQueue {
+public:
+    void push(int fd) {
+        {
+            std::lock_guard lock(mutex_);
+            connections_.push_back(fd);
+        }
+        ready_.notify_one();
+    }
+
+    // Blocks until a connection is available; -1 once closed.
+    int pop() {
+        std::unique_lock lock(mutex_);
+        ready_.wait(lock, [this] { return closed_ || !connections_.empty(); });
+        if (connections_.empty()) {
+            return -1;
+        }
+        const int fd = connections_.front();
+        connections_.pop_front();
+        return fd;
+    }
+
+    void close() {
+        {
+            std::lock_guard lock(mutex_);
+            closed_ = true;
+        }
+        ready_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<int> connections_;
+    bool closed_ = false;
+};
+
+void serve(int fd, Board& board) {
+    {
+        SocketBuffer buffer(fd);
+        std::istream in(&buffer);
+        std::ostream out(&buffer);
+        // Like stdin, a session opens with "uci"; the loop answers it.
+        std::string line;
+        if (std::getline(in, line) && line.starts_with("uci")) {
+            // The board is the worker's; start each client from a cold table
+            // and cache, as a fresh engine would. A shared table is left to
+            // the other sessions.
+            if (!board.hashTableShared()) {
+                board.hashTable().clear();
+            }
+            board.evalCache().clear();
+            SearchInfo info;
+            uci::loop(board, info, in, fd, out);
+        }
+    }
+    ::close(fd);
+}
+
+void session(ConnectionQueue& queue, const Options& options, HashTable* shared) {
+    auto board = std::make_unique<Board>();
+    if (shared != nullptr) {
+        board->shareHashTable(shared);
+    } else {
+        board->hashTable().init(options.hashMb);
+    }
+    board->evalCache().init(kDefaultEvalCache);
+
+    for (int fd = queue.pop(); fd >= 0; fd = queue.pop()) {
+        serve(fd, *board);
+    }
+}
+
+int listenUnix(const std::string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    ::unlink(path.c_str());
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(fd, kListenBacklog) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int listenTcp(int port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    const int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<std::uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(fd, kListenBacklog) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+} // namespace
+
+bool run(const Options& options) {
+    // A client that disconnects mid-write must not take the server down.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if (!options.book.empty() && !polybook::open(options.book.c_str())) {
+        std::cout << std::format("server: cannot open book {}\n", options.book);
+    }
+
+    const bool unix_socket = !options.socketPath.empty();
+    const int listener = unix_socket ? listenUnix(options.socketPath) : listenTcp(options.port);
+    if (listener < 0) {
+        std::cout << std::format("server: cannot listen on {}\n",
+                                 unix_socket ? options.socketPath : std::format("127.0.0.1:{}", options.port));
+        return false;
+    }
+
+    std::unique_ptr<HashTable> shared;
+    if (options.sharedHash) {
+        shared = std::make_unique<HashTable>();
+        shared->init(options.hashMb);
+    }
+
+    const int sessions = options.sessions > 0 ? options.sessions : 1;
+    ConnectionQueue queue;
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<std::size_t>(sessions));
+    for (int index = 0; index < sessions; ++index) {
+        workers.emplace_back(session, std::ref(queue), std::cref(options), shared.get());
+    }
+    std::cout << std::format("server: listening on {} with {} sessions, {} MB hash{}\n",
+                             unix_socket ? options.socketPath : std::format("127.0.0.1:{}", options.port),
+                             sessions, options.hashMb, options.sharedHash ? " shared" : " each")
+              << std::flush;
+
+    bool ok = true;
+    while (true) {
+        const int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            std::cout << std::format("server: accept failed: {}\n", std::strerror(errno));
+            ok = false;
+            break;
+        }
+        queue.push(client);
+    }
+
+    ::close(listener);
+    queue.close();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return ok;
+}
+
+#endif
+
+} // namespace chess::server
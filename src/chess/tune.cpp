@@ -0,0 +1,325 @@
+#include "chess/tune.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chess/binpos.hpp"
+#include "chess/evaluate.hpp"
+#include "chess/misc.hpp"
+#include "chess/position.hpp"
+
+namespace chess::tune {
+
+namespace {
+using Weights = std::array<double, eval::kNumParams>;
+
+constexpr double kBeta1 = 0.9;
+constexpr double kBeta2 = 0.999;
+constexpr double kEpsilon = 1e-8;
+constexpr double kMinScale = 1e-4;
+constexpr double kMaxScale = 0.05;
+constexpr int kScaleIterations = 40;
+// Stored scores are clamped so that mate-adjacent outliers do not dominate.
+constexpr float kMaxScore = 2000.0f;
+
+// Positions as sparse feature rows in struct-of-arrays form: row i owns
+// index_/coeff_[begin_[i], begin_[i + 1]). Three bytes per feature keeps tens
+// of millions of positions in memory and each row contiguous for the
+// dot-product and gradient loops.
+struct Dataset {
+    std::vector<std::uint32_t> begin{0};
+    std::vector<std::uint16_t> index;
+    std::vector<std::int8_t> coeff;
+    // Game result and search score, both from White's point of view;
+    // NaN when the record has no score.
+    std::vector<float> result;
+    std::vector<float> score;
+
+    [[nodiscard]] std::size_t size() const noexcept { return result.size(); }
+
+    void append(const Dataset& other) {
+        const std::uint32_t base = begin.back();
+        for (std::size_t row = 1; row < other.begin.size(); ++row) {
+            begin.push_back(base + other.begin[row]);
+        }
+        index.insert(index.end(), other.index.begin(), other.index.end());
+        coeff.insert(coeff.end(), other.coeff.begin(), other.coeff.end());
+        result.insert(result.end(), other.result.begin(), other.result.end());
+        score.insert(score.end(), other.score.begin(), other.score.end());
+    }
+};
+
+[[nodiscard]] float resultValue(binpos::GameResult result) noexcept {
+    switch (result) {
+        case binpos::GameResult::WhiteWin:
+            return 1.0f;
+        case binpos::GameResult::Draw:
+            return 0.5f;
+        case binpos::GameResult::BlackWin:
+            return 0.0f;
+    }
+    return 0.5f;
+}
+
+// Splits [0, count) evenly across threads and runs body(thread, first, last).
+template <typename Body>
+void parallelFor(int threads, std::size_t count, Body body) {
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<std::size_t>(threads));
+    for (int thread = 0; thread < threads; ++thread) {
+        const std::size_t first = count * static_cast<std::size_t>(thread) / static_cast<std::size_t>(threads);
+        const std::size_t last = count * static_cast<std::size_t>(thread + 1) / static_cast<std::size_t>(threads);
+        workers.emplace_back(body, thread, first, last);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+bool loadDataset(const std::string& path, int threads, Dataset& data) {
+    binpos::BinaryPositionReader reader;
+    if (!reader.open(path.c_str())) {
+        return false;
+    }
+
+    std::vector<Dataset> chunks(static_cast<std::size_t>(threads));
+    parallelFor(threads, reader.size(), [&](int thread, std::size_t first, std::size_t last) {
+        Dataset& chunk = chunks[static_cast<std::size_t>(thread)];
+        Position pos;
+        std::vector<eval::Feature> features;
+        const auto weights = eval::weights();
+        for (std::size_t row = first; row < last; ++row) {
+            const binpos::PackedPosition packed = reader.at(row);
+            if (!packed.result() || !binpos::unpack(packed, pos) || !eval::extractFeatures(pos, features)) {
+                continue;
+            }
+
+            [[maybe_unused]] int check = 0;
+            for (const auto& feature : features) {
+                chunk.index.push_back(feature.index);
+                chunk.coeff.push_back(static_cast<std::int8_t>(feature.coeff));
+                check += weights[feature.index] * feature.coeff;
+            }
+            assert(check == (pos.side() == Color::White ? eval::evaluate(pos) : -eval::evaluate(pos)));
+
+            chunk.begin.push_back(static_cast<std::uint32_t>(chunk.index.size()));
+            chunk.result.push_back(resultValue(*packed.result()));
+            if (const auto score = packed.score()) {
+                const float white_score = static_cast<float>(pos.side() == Color::White ? *score : -*score);
+                chunk.score.push_back(std::clamp(white_score, -kMaxScore, kMaxScore));
+            } else {
+                chunk.score.push_back(NAN);
+            }
+        }
+    });
+
+    for (const auto& chunk : chunks) {
+        data.append(chunk);
+    }
+    return true;
+}
+
+[[nodiscard]] inline double sigmoid(double x) noexcept {
+    return 1.0 / (1.0 + std::exp(-x));
+}
+
+[[nodiscard]] inline double rowEval(const Dataset& data, std::size_t row, const Weights& weights) noexcept {
+    double eval = 0.0;
+    for (std::uint32_t at = data.begin[row]; at < data.begin[row + 1]; ++at) {
+        eval += weights[data.index[at]] * data.coeff[at];
+    }
+    return eval;
+}
+
+[[nodiscard]] inline double rowTarget(const Dataset& data, std::size_t row, double scale, double lambda) noexcept {
+    const float score = data.score[row];
+    if (std::isnan(score)) {
+        return data.result[row];
+    }
+    return lambda * data.result[row] + (1.0 - lambda) * sigmoid(scale * score);
+}
+
+[[nodiscard]] inline double logLoss(double target, double predicted) noexcept {
+    predicted = std::clamp(predicted, 1e-12, 1.0 - 1e-12);
+    return -(target * std::log(predicted) + (1.0 - target) * std::log(1.0 - predicted));
+}
+
+// Mean loss over the dataset; adds the mean gradient to gradient if given.
+double evaluateLoss(const Dataset& data, const Weights& weights, double scale, double lambda, int threads,
+                    Weights* gradient) {
+    std::vector<double> losses(static_cast<std::size_t>(threads), 0.0);
+    std::vector<Weights> gradients(gradient != nullptr ? static_cast<std::size_t>(threads) : 0, Weights{});
+
+    parallelFor(threads, data.size(), [&](int thread, std::size_t first, std::size_t last) {
+        double loss = 0.0;
+        Weights* local = gradient != nullptr ? &gradients[static_cast<std::size_t>(thread)] : nullptr;
+        for (std::size_t row = first; row < last; ++row) {
+            const double target = rowTarget(data, row, scale, lambda);
+            const double predicted = sigmoid(scale * rowEval(data, row, weights));
+            loss += logLoss(target, predicted);
+            if (local != nullptr) {
+                // d(loss)/d(eval) for a logistic model is (predicted - target) * scale.
+                const double slope = (predicted - target) * scale;
+                for (std::uint32_t at = data.begin[row]; at < data.begin[row + 1]; ++at) {
+                    (*local)[data.index[at]] += slope * data.coeff[at];
+                }
+            }
+        }
+        losses[static_cast<std::size_t>(thread)] = loss;
+    });
+
+    const double count = static_cast<double>(data.size());
+    if (gradient != nullptr) {
+        for (const auto& local : gradients) {
+            for (std::size_t param = 0; param < gradient->size(); ++param) {
+                (*gradient)[param] += local[param] / count;
+            }
+        }
+    }
+    double loss = 0.0;
+    for (const double partial : losses) {
+        loss += partial;
+    }
+    return loss / count;
+}
+
+// Golden-section search for the sigmoid scale that best fits the game
+// results with the current weights.
+double fitScale(const Dataset& data, const Weights& weights, int threads) {
+    const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+    double low = kMinScale;
+    double high = kMaxScale;
+    for (int iteration = 0; iteration < kScaleIterations; ++iteration) {
+        const double left = high - ratio * (high - low);
+        const double right = low + ratio * (high - low);
+        if (evaluateLoss(data, weights, left, 1.0, threads, nullptr) <
+            evaluateLoss(data, weights, right, 1.0, threads, nullptr)) {
+            high = right;
+        } else {
+            low = left;
+        }
+    }
+    return (low + high) / 2.0;
+}
+
+std::string formatWeights(const Weights& weights) {
+    std::string text =
+        "// Evaluation weights. `chess tune` writes this file in the same layout; copy\n"
+        "// its output over this file to adopt tuned values.\n"
+        "#pragma once\n\n#include <array>\n\nnamespace chess::eval::params {\n";
+
+    for (int term = 0; term < static_cast<int>(eval::TermId::Count); ++term) {
+        const auto& info = eval::kTerms[term];
+        const int offset = eval::termOffset(static_cast<eval::TermId>(term));
+        auto value = [&](int index) { return std::lround(weights[static_cast<std::size_t>(offset + index)]); };
+
+        text += '\n';
+        if (info.size == 1) {
+            text += std::format("inline constexpr int {} = {};\n", info.name, value(0));
+            continue;
+        }
+        text += std::format("inline constexpr std::array<int, {}> {} = {{", info.size, info.name);
+        if (info.size <= 8) {
+            for (int index = 0; index < info.size; ++index) {
+                text += std::format("{}{}", index == 0 ? "" : ", ", value(index));
+            }
+            text += "};\n";
+            continue;
+        }
+        // Square tables print one rank per line, rank 1 first.
+        text += '\n';
+        for (int index = 0; index < info.size; ++index) {
+            std::string cell = std::format("{},", value(index));
+            if (index % 8 == 0) {
+                text += "    ";
+            }
+            if (index % 8 == 7) {
+                text += cell + '\n';
+            } else {
+                text += cell.size() < 5 ? std::format("{:<5}", cell) : cell + ' ';
+            }
+        }
+        text += "};\n";
+    }
+    text += "\n} // namespace chess::eval::params\n";
+    return text;
+}
+
+bool writeWeights(const std::string& path, const Weights& weights) {
+    const std::string text = formatWeights(weights);
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    const bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    return std::fclose(file) == 0 && written;
+}
+} // namespace
+
+bool run(const Options& options) {
+    const int threads = options.threads > 0 ? options.threads : 1;
+    const int start = misc::getTimeMs();
+
+    Dataset data;
+    if (!loadDataset(options.input, threads, data)) {
+        std::cout << std::format("tune: cannot read {}\n", options.input);
+        return false;
+    }
+    if (data.size() == 0) {
+        std::cout << std::format("tune: no labeled positions in {}\n", options.input);
+        return false;
+    }
+    std::cout << std::format("tune: {} positions, {} features, {} params, loaded in {} ms\n", data.size(),
+                             data.index.size(), eval::kNumParams, misc::getTimeMs() - start)
+              << std::flush;
+
+    const auto initial = eval::weights();
+    Weights weights{};
+    std::ranges::copy(initial, weights.begin());
+
+    const double scale = options.scale > 0.0 ? options.scale : fitScale(data, weights, threads);
+    std::cout << std::format("tune: scale {:.6f}, initial loss {:.6f}\n", scale,
+                             evaluateLoss(data, weights, scale, options.lambda, threads, nullptr))
+              << std::flush;
+
+    Weights gradient{};
+    Weights moment{};
+    Weights velocity{};
+    for (int epoch = 1; epoch <= options.epochs; ++epoch) {
+        std::ranges::fill(gradient, 0.0);
+        const double loss = evaluateLoss(data, weights, scale, options.lambda, threads, &gradient);
+
+        const double correction1 = 1.0 - std::pow(kBeta1, epoch);
+        const double correction2 = 1.0 - std::pow(kBeta2, epoch);
+        for (std::size_t param = 0; param < weights.size(); ++param) {
+            moment[param] = kBeta1 * moment[param] + (1.0 - kBeta1) * gradient[param];
+            velocity[param] = kBeta2 * velocity[param] + (1.0 - kBeta2) * gradient[param] * gradient[param];
+            weights[param] -= options.learningRate * (moment[param] / correction1) /
+                              (std::sqrt(velocity[param] / correction2) + kEpsilon);
+        }
+
+        if (options.reportInterval > 0 && (epoch % options.reportInterval == 0 || epoch == options.epochs)) {
+            std::cout << std::format("tune: epoch {} loss {:.6f} time {} ms\n", epoch, loss,
+                                     misc::getTimeMs() - start)
+                      << std::flush;
+        }
+    }
+
+    if (!writeWeights(options.output, weights)) {
+        std::cout << std::format("tune: cannot write {}\n", options.output);
+        return false;
+    }
+    std::cout << std::format("tune: wrote {}\n", options.output) << std::flush;
+    return true;
+}
+
+} // namespace chess::tune
@@ -1,12 +1,17 @@
 #include "chess/uci.hpp"
 
-#include <format>
 #include <iostream>
+#include <algorithm>
+#include <charconv>
 #include <string>
 #include <string_view>
 
 #include "chess/board.hpp"
+#include "chess/cpu.hpp"
 #include "chess/io.hpp"
+#include "chess/misc.hpp"
+#include "chess/perft.hpp"
+#include "chess/polybook.hpp"
 #include "chess/search.hpp"
 #include "chess/search_info.hpp"
 #include "chess/types.hpp"
@@ -18,13 +23,20 @@ constexpr std::string_view kAuthor = "Bluefever";
 constexpr int kDefaultHashSize = 64;
 constexpr int kMinHashSize = 4;
 
-void PrintUciInfo() {
-    std::cout << std::format("id name {}\n", kName);
-    std::cout << std::format("id author {}\n", kAuthor);
-    std::cout << std::format("option name Hash type spin default {} min {} max {}\n",
-                             kDefaultHashSize, kMinHashSize, kMaxHash);
-    std::cout << "option name Book type check default true\n";
-    std::cout << "uciok\n" << std::flush;
+void PrintUciInfo(std::ostream& out) {
+    misc::print(out, "id name {} ({})\n", kName, cpu::isaName(cpu::isa()));
+    misc::print(out, "id author {}\n", kAuthor);
+    misc::print(out, "option name Hash type spin default {} min {} max {}\n", kDefaultHashSize, kMinHashSize,
+                kMaxHash);
+    misc::print(out, "option name EvalCache type spin default {} min 0 max {}\n", kDefaultEvalCache,
+                kMaxEvalCache);
+    out << "option name Ponder type check default false\n";
+    out << "option name Search Stats type check default false\n";
+    out << "option name Book type check default true\n";
+    out << "option name Hash File type string default <empty>\n";
+    out << "option name Save Hash type button\n";
+    out << "option name Load Hash type button\n";
+    out << "uciok\n" << std::flush;
 }
 
 enum class UciCommand : std::uint8_t {
@@ -34,9 +46,175 @@ enum class UciCommand : std::uint8_t {
     kGo,
     kQuit,
     kUci,
+    kSetOption,
     kUnknown
 };
 
+// position [fen <fenstring> | startpos] [moves <move1> ... <movei>]
+void ParsePosition(std::string_view line, Board& board) {
+    constexpr std::string_view kFenToken = "fen ";
+    constexpr std::string_view kMovesToken = "moves";
+
+    const auto fen_pos = line.find(kFenToken);
+    if (fen_pos != std::string_view::npos) {
+        board.parseFen(line.substr(fen_pos + kFenToken.length()));
+    } else {
+        board.parseFen(kStartFen);
+    }
+
+    auto moves_pos = line.find(kMovesToken);
+    if (moves_pos != std::string_view::npos) {
+        std::string_view moves = line.substr(moves_pos + kMovesToken.length());
+        while (!moves.empty()) {
+            const auto start = moves.find_first_not_of(' ');
+            if (start == std::string_view::npos) {
+                break;
+            }
+            moves.remove_prefix(start);
+            const auto end = std::min(moves.find(' '), moves.length());
+            const auto move = io::parseMove(moves.substr(0, end), board);
+            if (!move) {
+                break;
+            }
+            board.makeMove(*move);
+            board.setPly(0);
+            moves.remove_prefix(end);
+        }
+    }
+}
+
+// Returns the integer following a "go" parameter, or fallback if absent.
+int ParseGoParameter(std::string_view line, std::string_view name, int fallback) {
+    const auto pos = line.find(name);
+    if (pos == std::string_view::npos) {
+        return fallback;
+    }
+    const char* first = line.data() + pos + name.length();
+    const char* last = line.data() + line.length();
+    while (first < last && *first == ' ') {
+        ++first;
+    }
+    int value = fallback;
+    std::from_chars(first, last, value);
+    return value;
+}
+
+// Whether a "go" flag without a value, such as ponder, is present.
+bool HasGoFlag(std::string_view line, std::string_view name) {
+    for (auto pos = line.find(name); pos != std::string_view::npos; pos = line.find(name, pos + 1)) {
+        const auto end = pos + name.length();
+        if ((pos == 0 || line[pos - 1] == ' ') && (end == line.length() || line[end] == ' ')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// A ponder or infinite search that finished early must not answer before
+// the GUI says so: wait for ponderhit (ponder only), stop or quit.
+void WaitForGui(SearchInfo& info, bool infinite) {
+    while ((info.ponder() || infinite) && !info.stopped()) {
+        // Blocks until a line arrives; readInput then handles it.
+        if (info.input().peek() == std::istream::traits_type::eof()) {
+            info.setQuit(true);
+            return;
+        }
+        misc::readInput(info);
+    }
+}
+
+// go [ponder] [infinite] [wtime|btime <ms>] [winc|binc <ms>] [movestogo <n>] [movetime <ms>]
+//    [depth <n>] [nodes <n>]
+void ParseGo(std::string_view line, Board& board, SearchInfo& info) {
+    const bool ponder = HasGoFlag(line, "ponder");
+    const bool infinite = HasGoFlag(line, "infinite");
+
+    const bool white = board.side() == Color::White;
+    search::SearchLimits limits;
+    limits.timeMs = ParseGoParameter(line, white ? "wtime" : "btime", -1);
+    limits.incrementMs = ParseGoParameter(line, white ? "winc" : "binc", 0);
+    limits.movesToGo = ParseGoParameter(line, "movestogo", 0);
+    limits.moveTimeMs = ParseGoParameter(line, "movetime", -1);
+    limits.depth = ParseGoParameter(line, "depth", 0);
+    limits.nodes = ParseGoParameter(line, "nodes", 0);
+    limits.ponder = ponder;
+
+    // The book plays games, so only timed searches use it: analysis (infinite,
+    // depth, nodes) wants the search, and a book move would answer a ponder
+    // search before ponderhit.
+    const bool timed = limits.timeMs >= 0 || limits.moveTimeMs >= 0;
+    const bool analysis = infinite || limits.depth > 0 || limits.nodes > 0;
+    if (info.useBook() && timed && !analysis && !ponder) {
+        const Move book_move = polybook::getBookMove(board);
+        if (book_move != Move{}) {
+            misc::print(info.output(), "bestmove {}\n", io::printMove(book_move));
+            info.output() << std::flush;
+            return;
+        }
+    }
+
+    search::applyLimits(limits, info);
+
+    const Move best_move = search::searchPosition(board, info);
+    WaitForGui(info, infinite);
+
+    const Move reply = search::expectedReply(board, best_move);
+    if (reply != Move{}) {
+        misc::print(info.output(), "bestmove {} ponder {}\n", io::printMove(best_move), io::printMove(reply));
+    } else {
+        misc::print(info.output(), "bestmove {}\n", io::printMove(best_move));
+    }
+    info.output() << std::flush;
+}
+
+// setoption name <id> [value <x>]
+void ParseSetOption(std::string_view line, Board& board, SearchInfo& info, std::string& hashFile,
+                    std::ostream& out) {
+    constexpr std::string_view kNameToken = "name ";
+    constexpr std::string_view kValueToken = " value ";
+
+    const auto name_pos = line.find(kNameToken);
+    if (name_pos == std::string_view::npos) {
+        return;
+    }
+    std::string_view name = line.substr(name_pos + kNameToken.length());
+    std::string_view value;
+    if (const auto value_pos = name.find(kValueToken); value_pos != std::string_view::npos) {
+        value = name.substr(value_pos + kValueToken.length());
+        name = name.substr(0, value_pos);
+    }
+
+    if (name == "Hash") {
+        int mb = 0;
+        std::from_chars(value.data(), value.data() + value.size(), mb);
+        if (mb >= kMinHashSize && !board.hashTableShared()) {
+            board.hashTable().init(std::min(mb, kMaxHash));
+        }
+    } else if (name == "EvalCache") {
+        int mb = -1;
+        std::from_chars(value.data(), value.data() + value.size(), mb);
+        if (mb >= 0) {
+            board.evalCache().init(std::min(mb, kMaxEvalCache));
+        }
+    } else if (name == "Search Stats") {
+        info.setReportStats(value == "true");
+    } else if (name == "Book") {
+        info.setUseBook(value == "true");
+    } else if (name == "Hash File") {
+        hashFile = value == "<empty>" ? std::string{} : std::string(value);
+    } else if (name == "Save Hash" || name == "Load Hash") {
+        const bool save = name == "Save Hash";
+        bool ok = false;
+        // A shared table belongs to every session: others may save it, not replace it.
+        if (!hashFile.empty() && (save || !board.hashTableShared())) {
+            ok = save ? board.hashTable().save(hashFile.c_str()) : board.hashTable().load(hashFile.c_str());
+        }
+        misc::print(out, "info string {} {} {}\n", save ? "save hash" : "load hash", ok ? "done" : "failed",
+                    hashFile);
+        out << std::flush;
+    }
+}
+
 constexpr UciCommand ParseUciCommand(std::string_view line) {
     if (line.starts_with("isready")) {
         return UciCommand::kIsReady;
@@ -56,21 +234,33 @@ constexpr UciCommand ParseUciCommand(std::string_view line) {
     if (line.starts_with("uci")) {
         return UciCommand::kUci;
     }
+    if (line.starts_with("setoption")) {
+        return UciCommand::kSetOption;
+    }
     return UciCommand::kUnknown;
 }
 } // namespace
 
 void loop(Board& board, SearchInfo& info) noexcept {
-    info.setGameMode(GameMode::Uci);
-
     // Synchronize streams for better performance in UCI mode
     std::ios::sync_with_stdio(false);
     std::cin.tie(nullptr);
 
-    PrintUciInfo();
+    loop(board, info, std::cin, 0, std::cout);
+}
+
+void loop(Board& board, SearchInfo& info, std::istream& in, int inFd, std::ostream& out) noexcept {
+    info.setGameMode(GameMode::Uci);
+    info.setPostThinking(true);
+    info.setInput(in, inFd);
+    info.setOutput(out);
 
+    PrintUciInfo(out);
+    ParsePosition("position startpos", board);
+
+    std::string hash_file;
     std::string line;
-    while (std::getline(std::cin, line)) {
+    while (std::getline(in, line)) {
         if (line.empty()) {
             continue;
         }
@@ -79,20 +269,29 @@ void loop(Board& board, SearchInfo& info) noexcept {
 
         switch (kCommand) {
             case UciCommand::kIsReady:
-                std::cout << "readyok\n" << std::flush;
+                out << "readyok\n" << std::flush;
                 break;
 
             case UciCommand::kPosition:
-                // TODO: Handle position command
+                ParsePosition(line, board);
                 break;
 
             case UciCommand::kUciNewGame:
-                // TODO: Handle new game
+                ParsePosition("position startpos", board);
+                if (!board.hashTableShared()) {
+                    board.hashTable().clear();
+                }
                 break;
 
             case UciCommand::kGo:
-                std::cout << "Seen Go..\n" << std::flush;
-                search::searchPosition(board, info);
+                if (line.find("perft") != std::string::npos) {
+                    perft::perftTest(board, ParseGoParameter(line, "perft", 1));
+                    break;
+                }
+                ParseGo(line, board, info);
+                if (info.quit()) {
+                    return;
+                }
                 break;
 
             case UciCommand::kQuit:
@@ -100,7 +299,11 @@ void loop(Board& board, SearchInfo& info) noexcept {
                 return;
 
             case UciCommand::kUci:
-                PrintUciInfo();
+                PrintUciInfo(out);
+                break;
+
+            case UciCommand::kSetOption:
+                ParseSetOption(line, board, info, hash_file, out);
                 break;
 
             case UciCommand::kUnknown:
@@ -1,25 +1,191 @@
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <span>
 #include <string>
 #include <string_view>
 
 #include "chess/board.hpp"
+#include "chess/book_builder.hpp"
+#include "chess/datagen.hpp"
 #include "chess/internal/init.hpp"
+#include "chess/position_index.hpp"
 #include "chess/search_info.hpp"
+#include "chess/server.hpp"
+#include "chess/tune.hpp"
 #include "chess/uci.hpp"
 #include "chess/xboard.hpp"
 
 namespace {
 constexpr int kDefaultHashSize = 64;
 
-void ProcessCommandLineArgs(std::span<const char* const> args) {
+void ProcessCommandLineArgs(std::span<const char* const> args, chess::Board& board, chess::SearchInfo& info) {
     auto contains_no_book = [](std::string_view arg) { return arg == "NoBook"; };
 
     if (std::ranges::any_of(args, contains_no_book)) {
-        chess::g_engineOptions.setUseBook(false);
+        info.setUseBook(false);
         std::cout << "Book Off\n";
     }
+
+    // LoadHash <path>: warm start from a table written by "Save Hash".
+    const auto load_hash = std::ranges::find(args, std::string_view{"LoadHash"});
+    if (load_hash != args.end() && std::next(load_hash) != args.end()) {
+        const char* path = *std::next(load_hash);
+        if (board.hashTable().load(path)) {
+            std::cout << "Hash loaded from " << path << "\n";
+        } else {
+            std::cout << "Hash not loaded from " << path << "\n";
+        }
+    }
+}
+
+template <typename T>
+bool ParseNumber(std::string_view text, T& value) {
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc{} && ptr == text.data() + text.size();
+}
+
+// A subcommand option: `name value` on the command line. parse stores the
+// value and returns false if it is not valid.
+struct Option {
+    std::string_view name;
+    std::function<bool(std::string_view)> parse;
+};
+
+template <typename T>
+std::function<bool(std::string_view)> Number(T& value) {
+    return [&value](std::string_view text) { return ParseNumber(text, value); };
+}
+
+std::function<bool(std::string_view)> Text(std::string& value) {
+    return [&value](std::string_view text) {
+        value = text;
+        return true;
+    };
+}
+
+// Applies `key value` pairs to the subcommand's options. Reports the first
+// unknown or bad option, or a key with no value, as "<command>: ...".
+bool ParseOptions(std::string_view command, std::span<const char* const> args, std::span<const Option> options) {
+    for (std::size_t index = 0; index + 1 < args.size(); index += 2) {
+        const std::string_view key = args[index];
+        const std::string_view value = args[index + 1];
+        const auto option = std::ranges::find(options, key, &Option::name);
+        if (option == options.end() || !option->parse(value)) {
+            std::cerr << command << ": bad option " << key << ' ' << value << '\n';
+            return false;
+        }
+    }
+    if (args.size() % 2 != 0) {
+        std::cerr << command << ": missing value for " << args.back() << '\n';
+        return false;
+    }
+    return true;
+}
+
+bool HasInput(std::string_view command, const std::string& input) {
+    if (input.empty()) {
+        std::cerr << command << ": no input file\n";
+        return false;
+    }
+    return true;
+}
+
+// chess datagen [threads N] [games N] [depth N] [nodes N] [random N] [hash MB]
+//               [seed N] [maxply N] [out PATH]
+bool ParseDatagenArgs(std::span<const char* const> args, chess::datagen::Options& options) {
+    const std::array<Option, 9> table = {{
+        {"threads", Number(options.threads)},
+        {"games", Number(options.games)},
+        {"depth",
+         [&options](std::string_view text) {
+             return ParseNumber(text, options.depth) && options.depth > 0 && options.depth < chess::kMaxDepth;
+         }},
+        {"nodes", Number(options.nodes)},
+        {"random", Number(options.randomPlies)},
+        {"hash", Number(options.hashMb)},
+        {"seed", Number(options.seed)},
+        {"maxply", Number(options.maxPly)},
+        {"out", Text(options.output)},
+    }};
+    return ParseOptions("datagen", args, table);
+}
+
+// chess tune input PATH [out PATH] [threads N] [epochs N] [lr X] [lambda X]
+//            [scale X]
+bool ParseTuneArgs(std::span<const char* const> args, chess::tune::Options& options) {
+    const std::array<Option, 7> table = {{
+        {"input", Text(options.input)},
+        {"out", Text(options.output)},
+        {"threads", Number(options.threads)},
+        {"epochs", Number(options.epochs)},
+        {"lr", Number(options.learningRate)},
+        {"lambda",
+         [&options](std::string_view text) {
+             return ParseNumber(text, options.lambda) && options.lambda >= 0.0 && options.lambda <= 1.0;
+         }},
+        {"scale", Number(options.scale)},
+    }};
+    return ParseOptions("tune", args, table) && HasInput("tune", options.input);
+}
+
+// chess book input PGN [out PATH] [threads N] [depth PLIES] [mingames N]
+bool ParseBookArgs(std::span<const char* const> args, chess::polybook::BuildOptions& options) {
+    const std::array<Option, 5> table = {{
+        {"input", Text(options.input)},
+        {"out", Text(options.output)},
+        {"threads", Number(options.threads)},
+        {"depth", Number(options.maxPly)},
+        {"mingames", Number(options.minGames)},
+    }};
+    return ParseOptions("book", args, table) && HasInput("book", options.input);
+}
+
+// chess index input PGN [out PATH] [threads N] [depth PLIES] [memory MB]
+bool ParseIndexArgs(std::span<const char* const> args, chess::posindex::BuildOptions& options) {
+    const std::array<Option, 5> table = {{
+        {"input", Text(options.input)},
+        {"out", Text(options.output)},
+        {"threads", Number(options.threads)},
+        {"depth", Number(options.maxPly)},
+        {"memory",
+         [&options](std::string_view text) { return ParseNumber(text, options.memoryMb) && options.memoryMb > 0; }},
+    }};
+    return ParseOptions("index", args, table) && HasInput("index", options.input);
+}
+
+// chess server (socket PATH | port N) [sessions N] [hash MB] [sharedhash 0|1] [book PATH]
+bool ParseServerArgs(std::span<const char* const> args, chess::server::Options& options) {
+    const std::array<Option, 6> table = {{
+        {"socket", Text(options.socketPath)},
+        {"port",
+         [&options](std::string_view text) {
+             return ParseNumber(text, options.port) && options.port > 0 && options.port < 65536;
+         }},
+        {"sessions",
+         [&options](std::string_view text) { return ParseNumber(text, options.sessions) && options.sessions > 0; }},
+        {"hash", [&options](std::string_view text) { return ParseNumber(text, options.hashMb) && options.hashMb > 0; }},
+        {"sharedhash",
+         [&options](std::string_view text) {
+             int shared = 0;
+             const bool ok = ParseNumber(text, shared) && (shared == 0 || shared == 1);
+             options.sharedHash = shared == 1;
+             return ok;
+         }},
+        {"book", Text(options.book)},
+    }};
+    if (!ParseOptions("server", args, table)) {
+        return false;
+    }
+    if (options.socketPath.empty() && options.port == 0) {
+        std::cerr << "server: no socket path or port\n";
+        return false;
+    }
+    return true;
 }
 
 enum class CommandType : std::uint8_t { kUci, kXBoard, kVice, kQuit, kUnknown };
@@ -45,17 +211,62 @@ int main(int argc, char* argv[]) {
     try {
         chess::internal::initializeAll();
 
-        chess::Board board;
+        if (argc > 1 && std::string_view(argv[1]) == "datagen") {
+            chess::datagen::Options options;
+            const auto args = std::span<const char* const>{argv, static_cast<std::size_t>(argc)}.subspan(2);
+            if (!ParseDatagenArgs(args, options)) {
+                return 1;
+            }
+            return chess::datagen::run(options) ? 0 : 1;
+        }
+        if (argc > 1 && std::string_view(argv[1]) == "tune") {
+            chess::tune::Options options;
+            const auto args = std::span<const char* const>{argv, static_cast<std::size_t>(argc)}.subspan(2);
+            if (!ParseTuneArgs(args, options)) {
+                return 1;
+            }
+            return chess::tune::run(options) ? 0 : 1;
+        }
+        if (argc > 1 && std::string_view(argv[1]) == "book") {
+            chess::polybook::BuildOptions options;
+            const auto args = std::span<const char* const>{argv, static_cast<std::size_t>(argc)}.subspan(2);
+            if (!ParseBookArgs(args, options)) {
+                return 1;
+            }
+            return chess::polybook::build(options) ? 0 : 1;
+        }
+        if (argc > 1 && std::string_view(argv[1]) == "index") {
+            chess::posindex::BuildOptions options;
+            const auto args = std::span<const char* const>{argv, static_cast<std::size_t>(argc)}.subspan(2);
+            if (!ParseIndexArgs(args, options)) {
+                return 1;
+            }
+            return chess::posindex::build(options) ? 0 : 1;
+        }
+        if (argc > 1 && std::string_view(argv[1]) == "server") {
+            chess::server::Options options;
+            const auto args = std::span<const char* const>{argv, static_cast<std::size_t>(argc)}.subspan(2);
+            if (!ParseServerArgs(args, options)) {
+                return 1;
+            }
+            return chess::server::run(options) ? 0 : 1;
+        }
+
+        // Board holds the per-ply state stack, too large for the main stack in
+        // copy-make builds.
+        auto board_ptr = std::make_unique<chess::Board>();
+        chess::Board& board = *board_ptr;
         chess::SearchInfo info;
         info.setQuit(false);
         board.hashTable().init(kDefaultHashSize);
+        board.evalCache().init(chess::kDefaultEvalCache);
 
         // Synchronize C++ streams with C stdio for better performance
         std::ios::sync_with_stdio(false);
         std::cin.tie(nullptr);
 
         // Process command line arguments
-        ProcessCommandLineArgs(std::span{argv, static_cast<std::size_t>(argc)});
+        ProcessCommandLineArgs(std::span{argv, static_cast<std::size_t>(argc)}, board, info);
 
         std::cout << "Welcome!\n" << std::flush;
 
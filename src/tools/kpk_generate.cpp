@@ -0,0 +1,170 @@
+// Solves king and pawn against king by retrograde analysis and writes the
+// result as the C++ table internal::g_kpkBitbase:
+//   kpk_generate OUTPUT.cpp
+// Run by the build; the engine only reads the table.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "chess/internal/kpk.hpp"
+
+namespace {
+using chess::internal::kKpkEntries;
+using chess::internal::kKpkWords;
+using chess::internal::kpkIndex;
+
+// Bit flags, so that the results of several moves can be OR-ed together.
+enum Result : std::uint8_t { kInvalid = 0, kUnknown = 1, kDraw = 2, kWin = 4 };
+
+constexpr int kNorth = 8;
+
+int FileOf(int sq) {
+    return sq & 7;
+}
+
+int RankOf(int sq) {
+    return sq >> 3;
+}
+
+int Distance(int a, int b) {
+    return std::max(std::abs(FileOf(a) - FileOf(b)), std::abs(RankOf(a) - RankOf(b)));
+}
+
+bool PawnAttacks(int pawn, int sq) {
+    return RankOf(sq) == RankOf(pawn) + 1 && std::abs(FileOf(sq) - FileOf(pawn)) == 1;
+}
+
+struct Position {
+    bool blackToMove;
+    int whiteKing;
+    int blackKing;
+    int pawn;
+    Result result;
+};
+
+Position Decode(int index) {
+    Position pos{};
+    pos.whiteKing = index & 63;
+    pos.blackKing = (index >> 6) & 63;
+    pos.blackToMove = ((index >> 12) & 1) != 0;
+    pos.pawn = (6 - ((index >> 15) & 7)) * 8 + ((index >> 13) & 3);
+    return pos;
+}
+
+// Results that follow from the position alone.
+Result Initial(const Position& pos) {
+    if (Distance(pos.whiteKing, pos.blackKing) <= 1 || pos.whiteKing == pos.pawn || pos.blackKing == pos.pawn ||
+        (!pos.blackToMove && PawnAttacks(pos.pawn, pos.blackKing))) {
+        return kInvalid;
+    }
+
+    // The pawn promotes and the queen cannot be taken.
+    const int push = pos.pawn + kNorth;
+    if (!pos.blackToMove && RankOf(pos.pawn) == 6 && pos.whiteKing != push &&
+        (Distance(pos.blackKing, push) > 1 || Distance(pos.whiteKing, push) == 1)) {
+        return kWin;
+    }
+
+    if (pos.blackToMove) {
+        bool can_move = false;
+        for (int sq = 0; sq < 64; ++sq) {
+            if (Distance(sq, pos.blackKing) != 1 || Distance(sq, pos.whiteKing) <= 1) {
+                continue;
+            }
+            // Taking the undefended pawn leaves a bare king each.
+            if (sq == pos.pawn) {
+                return kDraw;
+            }
+            can_move = can_move || !PawnAttacks(pos.pawn, sq);
+        }
+        if (!can_move) {
+            // King and pawn cannot mate before promotion, so this is stalemate.
+            return kDraw;
+        }
+    }
+    return kUnknown;
+}
+
+// Combines the results of the side to move's moves.
+Result Classify(const std::vector<Position>& positions, const Position& pos) {
+    const Result good = pos.blackToMove ? kDraw : kWin;
+    const Result bad = pos.blackToMove ? kWin : kDraw;
+
+    int results = kInvalid;
+    const int king = pos.blackToMove ? pos.blackKing : pos.whiteKing;
+    for (int sq = 0; sq < 64; ++sq) {
+        if (Distance(sq, king) != 1) {
+            continue;
+        }
+        const int index = pos.blackToMove ? kpkIndex(false, pos.whiteKing, sq, pos.pawn)
+                                          : kpkIndex(true, sq, pos.blackKing, pos.pawn);
+        results |= positions[static_cast<std::size_t>(index)].result;
+    }
+
+    if (!pos.blackToMove && RankOf(pos.pawn) < 6) {
+        const int push = pos.pawn + kNorth;
+        results |= positions[static_cast<std::size_t>(kpkIndex(true, pos.whiteKing, pos.blackKing, push))].result;
+        if (RankOf(pos.pawn) == 1 && push != pos.whiteKing && push != pos.blackKing) {
+            results |= positions[static_cast<std::size_t>(
+                                     kpkIndex(true, pos.whiteKing, pos.blackKing, push + kNorth))]
+                           .result;
+        }
+    }
+
+    if ((results & good) != 0) {
+        return good;
+    }
+    return (results & kUnknown) != 0 ? kUnknown : bad;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: kpk_generate OUTPUT.cpp\n");
+        return 1;
+    }
+
+    std::vector<Position> positions(kKpkEntries);
+    for (int index = 0; index < kKpkEntries; ++index) {
+        Position& pos = positions[static_cast<std::size_t>(index)];
+        pos = Decode(index);
+        pos.result = Initial(pos);
+    }
+
+    // Resolve positions from their successors until nothing changes.
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (Position& pos : positions) {
+            if (pos.result == kUnknown) {
+                pos.result = Classify(positions, pos);
+                changed = changed || pos.result != kUnknown;
+            }
+        }
+    }
+
+    std::array<std::uint32_t, kKpkWords> words{};
+    for (int index = 0; index < kKpkEntries; ++index) {
+        if (positions[static_cast<std::size_t>(index)].result == kWin) {
+            words[static_cast<std::size_t>(index) >> 5] |= 1U << (index & 31);
+        }
+    }
+
+    std::FILE* out = std::fopen(argv[1], "w");
+    if (out == nullptr) {
+        std::fprintf(stderr, "kpk_generate: cannot write %s\n", argv[1]);
+        return 1;
+    }
+    std::fprintf(out, "// Generated by kpk_generate; do not edit.\n\n");
+    std::fprintf(out, "#include \"chess/internal/kpk.hpp\"\n\nnamespace chess::internal {\n\n");
+    std::fprintf(out, "const std::array<std::uint32_t, kKpkWords> g_kpkBitbase = {{\n");
+    for (std::size_t index = 0; index < words.size(); ++index) {
+        std::fprintf(out, "%s0x%08XU,%s", index % 8 == 0 ? "    " : " ", static_cast<unsigned>(words[index]),
+                     index % 8 == 7 ? "\n" : "");
+    }
+    std::fprintf(out, "}};\n\n} // namespace chess::internal\n");
+    return std::fclose(out) == 0 ? 0 : 1;
+}
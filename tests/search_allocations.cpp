@@ -0,0 +1,113 @@
+// Fails if searchPosition allocates on the heap. Built with
+// CHESS_TRACK_ALLOCATIONS; chess_allocations counts every operator new.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string_view>
+#include <thread>
+
+#include "chess/allocations.hpp"
+#include "chess/board.hpp"
+#include "chess/hash.hpp"
+#include "chess/internal/init.hpp"
+#include "chess/search.hpp"
+#include "chess/search_info.hpp"
+#include "chess/types.hpp"
+
+namespace {
+constexpr int kHashSizeMb = 16;
+constexpr int kDepth = 6;
+constexpr auto kSignalDelay = std::chrono::milliseconds(200);
+constexpr std::string_view kMiddlegame = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+// Swallows the search output so that formatting is exercised without a
+// growing buffer.
+class NullBuffer : public std::streambuf {
+protected:
+    int_type overflow(int_type ch) override { return traits_type::not_eof(ch); }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// Searches fen and reports whether the search allocated. Whatever setup
+// needs, such as a thread that raises a signal, is made before counting.
+bool Check(std::string_view name, chess::Board& board, std::string_view fen, chess::SearchInfo& info,
+           const chess::search::SearchLimits& limits, const std::function<void()>& setup = {}) {
+    board.parseFen(fen);
+    board.hashTable().clear();
+    board.evalCache().clear();
+    chess::search::applyLimits(limits, info);
+    if (setup) {
+        setup();
+    }
+
+    const std::uint64_t before = chess::allocations::count();
+    static_cast<void>(chess::search::searchPosition(board, info));
+    const std::uint64_t allocated = chess::allocations::count() - before;
+
+    std::cout << std::format("{:<12} {} allocations\n", name, allocated);
+    return allocated == 0;
+}
+} // namespace
+
+int main() {
+    chess::internal::initializeAll();
+
+    auto board = std::make_unique<chess::Board>();
+    board->hashTable().init(kHashSizeMb);
+    board->evalCache().init(chess::kDefaultEvalCache);
+
+    NullBuffer null_buffer;
+    std::ostream null_output(&null_buffer);
+    chess::SearchInfo info;
+    info.setPollInput(false);
+    info.setPostThinking(true);
+    info.setOutput(null_output);
+
+    chess::search::SearchLimits fixed;
+    fixed.depth = kDepth;
+    bool ok = Check("startpos", *board, chess::kStartFen, info, fixed);
+    ok = Check("middlegame", *board, kMiddlegame, info, fixed) && ok;
+
+    info.setReportStats(true);
+    info.setOnIteration([](const chess::SearchIteration&) {});
+    ok = Check("stats", *board, kMiddlegame, info, fixed) && ok;
+    info.setReportStats(false);
+    info.setOnIteration({});
+
+    // Ponder until the hit, then finish on a short budget.
+    std::atomic<bool> ponder_hit{false};
+    std::thread hitter;
+    info.setPonderHitSignal(&ponder_hit);
+    chess::search::SearchLimits ponder;
+    ponder.ponder = true;
+    ponder.moveTimeMs = 300;
+    ok = Check("ponder", *board, kMiddlegame, info, ponder, [&] {
+        hitter = std::thread([&] {
+            std::this_thread::sleep_for(kSignalDelay);
+            ponder_hit = true;
+        });
+    }) && ok;
+    hitter.join();
+    info.setPonderHitSignal(nullptr);
+
+    // An infinite search ended by stop.
+    std::atomic<bool> stop{false};
+    std::thread stopper;
+    info.setStopSignal(&stop);
+    ok = Check("stop", *board, kMiddlegame, info, chess::search::SearchLimits{}, [&] {
+        stopper = std::thread([&] {
+            std::this_thread::sleep_for(kSignalDelay);
+            stop = true;
+        });
+    }) && ok;
+    stopper.join();
+    info.setStopSignal(nullptr);
+
+    return ok ? 0 : 1;
+}